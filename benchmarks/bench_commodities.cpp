@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "units/commodity_conversion_maps.hpp"
+#include "units/units.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace units;
+
+// all the names in the defined commodity table
+static std::vector<std::string> commodityNames()
+{
+    std::vector<std::string> names;
+    for (const auto& pr : commodities::defined_commodity_codes) {
+        if (pr.second != 0U) {
+            names.emplace_back(pr.first);
+        }
+    }
+    return names;
+}
+
+static void BM_getCommodityDefined(benchmark::State& state)
+{
+    auto names = commodityNames();
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto code = getCommodity(names[index]);
+        benchmark::DoNotOptimize(code);
+        if (++index == names.size()) {
+            index = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_getCommodityDefined);
+
+// names which are not in the table so produce a hashed or custom code
+static void BM_getCommodityUndefined(benchmark::State& state)
+{
+    const std::vector<std::string> names{
+        "durum wheat", "saffron", "recycled aluminum", "heavy water",
+        "arabica beans"};
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto code = getCommodity(names[index]);
+        benchmark::DoNotOptimize(code);
+        if (++index == names.size()) {
+            index = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_getCommodityUndefined);
+
+static void BM_commodityUnitFromString(benchmark::State& state)
+{
+    const std::vector<std::string> strings{
+        "kg{wheat}/acre", "$/bbl{oil}", "lb{cotton}", "t{coal}/yr"};
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto unit = unit_from_string(strings[index]);
+        benchmark::DoNotOptimize(unit);
+        if (++index == strings.size()) {
+            index = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_commodityUnitFromString);
+
+// commodity names which are not in the defined table
+static void BM_commodityUnknownFromString(benchmark::State& state)
+{
+    const std::vector<std::string> strings{
+        "kg{durum}/acre", "$/bbl{brent}", "lb{pima}", "t{lignite}/yr"};
+    const std::uint64_t flags =
+        (state.range(0) != 0) ? std::uint64_t{no_commodity_interning} : 0U;
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto unit = unit_from_string(strings[index], flags);
+        benchmark::DoNotOptimize(unit);
+        if (++index == strings.size()) {
+            index = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel((state.range(0) != 0) ? "no interning" : "interning");
+}
+BENCHMARK(BM_commodityUnknownFromString)->Arg(0)->Arg(1);
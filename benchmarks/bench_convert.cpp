@@ -0,0 +1,280 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "units/units.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+using namespace units;
+
+static void BM_convertLinear(benchmark::State& state)
+{
+    double val{1.0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(val);
+        auto res = convert(val, precise::ft, precise::m);
+        benchmark::DoNotOptimize(res);
+    }
+}
+BENCHMARK(BM_convertLinear);
+
+static void BM_converterLinear(benchmark::State& state)
+{
+    converter conv(precise::ft, precise::m);
+    double val{1.0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(val);
+        auto res = conv(val);
+        benchmark::DoNotOptimize(res);
+    }
+}
+BENCHMARK(BM_converterLinear);
+
+static void BM_convertTemperature(benchmark::State& state)
+{
+    double val{1.0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(val);
+        auto res = convert(
+            val, precise::temperature::degF, precise::temperature::degC);
+        benchmark::DoNotOptimize(res);
+    }
+}
+BENCHMARK(BM_convertTemperature);
+
+static void BM_converterTemperature(benchmark::State& state)
+{
+    converter conv(precise::temperature::degF, precise::temperature::degC);
+    double val{1.0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(val);
+        auto res = conv(val);
+        benchmark::DoNotOptimize(res);
+    }
+}
+BENCHMARK(BM_converterTemperature);
+
+static void BM_convertMassToWeight(benchmark::State& state)
+{
+    double val{1.0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(val);
+        auto res = convert(val, precise::lb, precise::N);
+        benchmark::DoNotOptimize(res);
+    }
+}
+BENCHMARK(BM_convertMassToWeight);
+
+static void BM_converterMassToWeight(benchmark::State& state)
+{
+    converter conv(precise::lb, precise::N);
+    double val{1.0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(val);
+        auto res = conv(val);
+        benchmark::DoNotOptimize(res);
+    }
+}
+BENCHMARK(BM_converterMassToWeight);
+
+// a unit pair exercising each of the branches in convert
+struct conversionCase {
+    const char* name;
+    precise_unit start;
+    precise_unit result;
+};
+
+static const std::vector<conversionCase> conversionBranches{
+    {"identical", precise::m, precise::m},
+    {"same_base", precise::ft, precise::m},
+    {"flagged_temperature",
+     precise::temperature::degF,
+     precise::temperature::degC},
+    {"flagged_gauge", precise::pressure::psig, precise::pressure::psi},
+    {"equation", precise::log::dB * precise::milli * precise::W, precise::W},
+    {"per_unit_pair", precise::pu * precise::V, precise::pu * precise::A},
+    {"per_unit_assumed_base", precise::pu * precise::Hz, precise::Hz},
+    {"counting", precise::mol, precise::count},
+    {"inverse", precise::Hz, precise::s},
+    {"other_useful", precise::lb, precise::N},
+    {"invalid", precise::m, precise::kg},
+};
+
+static void BM_convertBranch(benchmark::State& state)
+{
+    const auto& branch =
+        conversionBranches[static_cast<std::size_t>(state.range(0))];
+    double val{1.0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(val);
+        auto res = convert(val, branch.start, branch.result);
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetLabel(branch.name);
+}
+BENCHMARK(BM_convertBranch)
+    ->DenseRange(0, static_cast<int>(conversionBranches.size()) - 1);
+
+static void BM_convertPerUnitBase(benchmark::State& state)
+{
+    double val{1.0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(val);
+        auto res = convert(val, precise::pu * precise::ohm, precise::ohm, 5.0);
+        benchmark::DoNotOptimize(res);
+    }
+}
+BENCHMARK(BM_convertPerUnitBase);
+
+static void BM_convertPowerSystemBase(benchmark::State& state)
+{
+    double val{1.0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(val);
+        auto res = convert(
+            val, precise::pu * precise::ohm, precise::ohm, 100.0, 13.8);
+        benchmark::DoNotOptimize(res);
+    }
+}
+BENCHMARK(BM_convertPowerSystemBase);
+
+static std::vector<double> generateValues(std::size_t count)
+{
+    std::vector<double> values(count);
+    for (std::size_t ii = 0; ii < count; ++ii) {
+        values[ii] = static_cast<double>(ii % 1000) * 0.37 - 40.0;
+    }
+    return values;
+}
+
+// the scalar convert function applied to each element
+static void BM_convertArrayScalarLoop(benchmark::State& state)
+{
+    auto input = generateValues(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> output(input.size());
+    for (auto _ : state) {
+        for (std::size_t ii = 0; ii < input.size(); ++ii) {
+            output[ii] = convert(input[ii], precise::ft, precise::m);
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(
+        state.iterations() * state.range(0) *
+        static_cast<std::int64_t>(2 * sizeof(double)));
+}
+BENCHMARK(BM_convertArrayScalarLoop)->Arg(4096)->Arg(1 << 20);
+
+static void BM_convertArray(benchmark::State& state)
+{
+    auto input = generateValues(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> output(input.size());
+    for (auto _ : state) {
+        convert(
+            input.data(), output.data(), input.size(), precise::ft, precise::m);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(
+        state.iterations() * state.range(0) *
+        static_cast<std::int64_t>(2 * sizeof(double)));
+}
+BENCHMARK(BM_convertArray)->Arg(4096)->Arg(1 << 20);
+
+static void BM_convertArrayTemperatureScalarLoop(benchmark::State& state)
+{
+    auto input = generateValues(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> output(input.size());
+    for (auto _ : state) {
+        for (std::size_t ii = 0; ii < input.size(); ++ii) {
+            output[ii] = convert(
+                input[ii],
+                precise::temperature::degF,
+                precise::temperature::degC);
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(
+        state.iterations() * state.range(0) *
+        static_cast<std::int64_t>(2 * sizeof(double)));
+}
+BENCHMARK(BM_convertArrayTemperatureScalarLoop)->Arg(4096)->Arg(1 << 20);
+
+static void BM_convertArrayTemperature(benchmark::State& state)
+{
+    auto input = generateValues(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> output(input.size());
+    for (auto _ : state) {
+        convert(
+            input.data(),
+            output.data(),
+            input.size(),
+            precise::temperature::degF,
+            precise::temperature::degC);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(
+        state.iterations() * state.range(0) *
+        static_cast<std::int64_t>(2 * sizeof(double)));
+}
+BENCHMARK(BM_convertArrayTemperature)->Arg(4096)->Arg(1 << 20);
+
+static void BM_convertArrayEquationScalarLoop(benchmark::State& state)
+{
+    const precise_unit dBm = precise::log::dB * precise::milli * precise::W;
+    auto input = generateValues(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> output(input.size());
+    for (auto _ : state) {
+        for (std::size_t ii = 0; ii < input.size(); ++ii) {
+            output[ii] = convert(input[ii], dBm, precise::W);
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_convertArrayEquationScalarLoop)->Arg(4096);
+
+// the same conversion as BM_convertArrayEquation with the exact scalar
+// equation functions, which is the path taken by header only builds
+static void BM_convertArrayEquationExact(benchmark::State& state)
+{
+    const precise_unit dBm = precise::log::dB * precise::milli * precise::W;
+    const auto base = dBm.base_units();
+    const double scale = dBm.multiplier() / precise::W.multiplier();
+    auto input = generateValues(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> output(input.size());
+    for (auto _ : state) {
+        for (std::size_t ii = 0; ii < input.size(); ++ii) {
+            output[ii] =
+                precise::equations::convert_equnit_to_value(input[ii], base) *
+                scale;
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_convertArrayEquationExact)->Arg(4096);
+
+// uses the vectorized exp2Values kernel
+static void BM_convertArrayEquation(benchmark::State& state)
+{
+    const precise_unit dBm = precise::log::dB * precise::milli * precise::W;
+    auto input = generateValues(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> output(input.size());
+    for (auto _ : state) {
+        convert(input.data(), output.data(), input.size(), dBm, precise::W);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_convertArrayEquation)->Arg(4096);
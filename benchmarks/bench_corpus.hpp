@@ -0,0 +1,267 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+/** @file loaders for the unit string corpora in test/files used as benchmark
+inputs*/
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/// the available corpora of unit strings
+enum corpus : int {
+    udunits = 0,
+    ucum = 1,
+    pint = 2,
+    google = 3,
+    complete_list = 4,
+};
+
+constexpr int corpusCount{5};
+
+inline std::string trim(const std::string& str)
+{
+    static const char* whitespace = " \t\r\n";
+    auto start = str.find_first_not_of(whitespace);
+    if (start == std::string::npos) {
+        return std::string{};
+    }
+    auto stop = str.find_last_not_of(whitespace);
+    return str.substr(start, stop - start + 1);
+}
+
+/// load the text between all the matching open and close tags in an xml file
+inline void loadXmlTags(
+    const std::string& file,
+    const std::string& tag,
+    std::vector<std::string>& strings)
+{
+    std::ifstream xfile(file);
+    if (!xfile.is_open()) {
+        return;
+    }
+    const std::string open = "<" + tag + ">";
+    const std::string close = "</" + tag + ">";
+    std::string line;
+    while (std::getline(xfile, line)) {
+        auto loc = line.find(open);
+        while (loc != std::string::npos) {
+            auto start = loc + open.size();
+            auto stop = line.find(close, start);
+            if (stop == std::string::npos) {
+                break;
+            }
+            auto str = trim(line.substr(start, stop - start));
+            if (!str.empty()) {
+                strings.push_back(str);
+            }
+            loc = line.find(open, stop);
+        }
+    }
+}
+
+/// the symbols and names from the UDUNITS2 xml files
+inline std::vector<std::string> udunitsStrings()
+{
+    std::vector<std::string> strings;
+    for (const char* file :
+         {"/UDUNITS2/udunits2-accepted.xml",
+          "/UDUNITS2/udunits2-common.xml",
+          "/UDUNITS2/udunits2-derived.xml"}) {
+        const std::string path = std::string(BENCHMARK_FILE_FOLDER) + file;
+        loadXmlTags(path, "symbol", strings);
+        loadXmlTags(path, "singular", strings);
+    }
+    return strings;
+}
+
+/// the case sensitive codes from the ucum definitions
+inline std::vector<std::string> ucumStrings()
+{
+    std::vector<std::string> strings;
+    std::ifstream jfile(BENCHMARK_FILE_FOLDER "/ucumDefs.json");
+    if (!jfile.is_open()) {
+        return strings;
+    }
+    const std::string key = "\"csCode_\":";
+    std::string line;
+    while (std::getline(jfile, line)) {
+        auto loc = line.find(key);
+        if (loc == std::string::npos) {
+            continue;
+        }
+        auto start = line.find('"', loc + key.size());
+        auto stop = (start == std::string::npos) ?
+            std::string::npos :
+            line.find('"', start + 1);
+        if (stop != std::string::npos && stop > start + 1) {
+            strings.push_back(line.substr(start + 1, stop - start - 1));
+        }
+    }
+    return strings;
+}
+
+/// the unit names, symbols, and aliases from the pint definitions file
+inline std::vector<std::string> pintStrings()
+{
+    std::vector<std::string> strings;
+    std::ifstream pfile(BENCHMARK_FILE_FOLDER "/pint_units.txt");
+    if (!pfile.is_open()) {
+        return strings;
+    }
+    std::string line;
+    while (std::getline(pfile, line)) {
+        if (line.empty() || line[0] == '#' || line[0] == '@' ||
+            line[0] == ' ' || line[0] == '\t') {
+            continue;
+        }
+        auto comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::size_t start{0};
+        int field{0};
+        while (start < line.size()) {
+            auto stop = line.find('=', start);
+            auto str = trim(line.substr(start, stop - start));
+            // the second field is the definition
+            if (field != 1 && !str.empty() && str != "_" &&
+                str.back() != '-' && str.find('[') == std::string::npos &&
+                str.find(':') == std::string::npos) {
+                strings.push_back(str);
+            }
+            if (stop == std::string::npos) {
+                break;
+            }
+            start = stop + 1;
+            ++field;
+        }
+    }
+    return strings;
+}
+
+/// the unit names listed by type in google_defined_units.txt
+inline std::vector<std::string> googleStrings()
+{
+    std::vector<std::string> strings;
+    std::ifstream gfile(BENCHMARK_FILE_FOLDER "/google_defined_units.txt");
+    if (!gfile.is_open()) {
+        return strings;
+    }
+    std::string line;
+    while (std::getline(gfile, line)) {
+        auto start = line.find_first_of(':');
+        if (start == std::string::npos) {
+            continue;
+        }
+        ++start;
+        while (start < line.size()) {
+            auto stop = line.find(',', start);
+            auto str = trim(line.substr(start, stop - start));
+            if (!str.empty()) {
+                strings.push_back(str);
+            }
+            if (stop == std::string::npos) {
+                break;
+            }
+            start = stop + 1;
+        }
+    }
+    return strings;
+}
+
+/// decode the quoted printable encoding used in complete_unit_list.txt
+inline std::string hexConvert(const std::string& str)
+{
+    auto hexValue = [](char hex) {
+        if (hex >= '0' && hex <= '9') {
+            return hex - '0';
+        }
+        if (hex >= 'A' && hex <= 'F') {
+            return hex - 'A' + 10;
+        }
+        if (hex >= 'a' && hex <= 'f') {
+            return hex - 'a' + 10;
+        }
+        return -1;
+    };
+    std::string outstring;
+    outstring.reserve(str.size());
+    std::size_t loc{0};
+    while (loc < str.size()) {
+        if (loc + 2 < str.size() && str[loc] == '=') {
+            auto high = hexValue(str[loc + 1]);
+            auto low = hexValue(str[loc + 2]);
+            if (high >= 0 && low >= 0) {
+                outstring.push_back(static_cast<char>(high * 16 + low));
+                loc += 3;
+                continue;
+            }
+        }
+        outstring.push_back(str[loc]);
+        ++loc;
+    }
+    return outstring;
+}
+
+/// the first field of each entry in complete_unit_list.txt
+inline std::vector<std::string> completeListStrings()
+{
+    std::vector<std::string> strings;
+    std::ifstream cfile(BENCHMARK_FILE_FOLDER "/complete_unit_list.txt");
+    if (!cfile.is_open()) {
+        return strings;
+    }
+    std::string line;
+    while (std::getline(cfile, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        auto str = trim(hexConvert(line.substr(0, line.find(','))));
+        if (!str.empty()) {
+            strings.push_back(str);
+        }
+    }
+    return strings;
+}
+
+inline const char* corpusName(int index)
+{
+    switch (index) {
+        case udunits:
+            return "UDUNITS2";
+        case ucum:
+            return "ucum";
+        case pint:
+            return "pint";
+        case google:
+            return "google";
+        case complete_list:
+            return "complete_unit_list";
+        default:
+            return "unknown";
+    }
+}
+
+/// get one of the corpora, the files are only read once
+inline const std::vector<std::string>& corpusStrings(int index)
+{
+    static const std::vector<std::string> corpora[corpusCount]{
+        udunitsStrings(),
+        ucumStrings(),
+        pintStrings(),
+        googleStrings(),
+        completeListStrings()};
+    static const std::vector<std::string> empty;
+    return (index >= 0 && index < corpusCount) ? corpora[index] : empty;
+}
+
+}  // namespace bench
@@ -0,0 +1,272 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "bench_corpus.hpp"
+#include "units/units.hpp"
+
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace units;
+
+// run a parse function over every string in a corpus in turn
+template<typename Parser>
+static void parseCorpus(
+    benchmark::State& state,
+    const std::vector<std::string>& strings,
+    Parser parser)
+{
+    if (strings.empty()) {
+        state.SkipWithError("corpus file could not be loaded");
+        return;
+    }
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto res = parser(strings[index]);
+        benchmark::DoNotOptimize(res);
+        if (++index == strings.size()) {
+            index = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(bench::corpusName(static_cast<int>(state.range(0))));
+}
+
+// prefix every string in a corpus with a value
+static std::vector<std::string>
+    measurementStrings(int index, const std::string& prefix)
+{
+    std::vector<std::string> strings;
+    for (const auto& str : bench::corpusStrings(index)) {
+        strings.push_back(prefix + str);
+    }
+    return strings;
+}
+
+static void BM_unitFromString(benchmark::State& state)
+{
+    parseCorpus(
+        state,
+        bench::corpusStrings(static_cast<int>(state.range(0))),
+        [](const std::string& str) { return unit_from_string(str); });
+}
+BENCHMARK(BM_unitFromString)->DenseRange(0, bench::corpusCount - 1);
+
+static void BM_measurementFromString(benchmark::State& state)
+{
+    parseCorpus(
+        state,
+        measurementStrings(static_cast<int>(state.range(0)), "12.75 "),
+        [](const std::string& str) { return measurement_from_string(str); });
+}
+BENCHMARK(BM_measurementFromString)->DenseRange(0, bench::corpusCount - 1);
+
+static void BM_uncertainMeasurementFromString(benchmark::State& state)
+{
+    parseCorpus(
+        state,
+        measurementStrings(
+            static_cast<int>(state.range(0)), "12.75+/-0.05 "),
+        [](const std::string& str) {
+            return uncertain_measurement_from_string(str);
+        });
+}
+BENCHMARK(BM_uncertainMeasurementFromString)
+    ->DenseRange(0, bench::corpusCount - 1);
+
+// a column of measurements with a few repeated units
+static std::vector<std::string> measurementColumn()
+{
+    const std::vector<std::string> units{"kg", "lb", "m/s", "kWh"};
+    std::vector<std::string> strings;
+    for (int ii = 0; ii < 1000; ++ii) {
+        strings.push_back(
+            std::to_string(ii * 0.25) + ' ' + units[ii % units.size()]);
+    }
+    return strings;
+}
+
+static void BM_measurementColumn(benchmark::State& state)
+{
+    const auto strings = measurementColumn();
+    for (auto _ : state) {
+        for (const auto& str : strings) {
+            auto res = measurement_from_string(str);
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(strings.size()));
+}
+BENCHMARK(BM_measurementColumn);
+
+static void BM_measurementColumnBatch(benchmark::State& state)
+{
+    const auto strings = measurementColumn();
+    std::vector<precise_measurement> results;
+    for (auto _ : state) {
+        auto valid = measurement_from_string(strings, results);
+        benchmark::DoNotOptimize(valid);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(strings.size()));
+}
+BENCHMARK(BM_measurementColumnBatch);
+
+// scaling of the threaded batch conversion on a larger column
+static void BM_measurementColumnThreads(benchmark::State& state)
+{
+    std::vector<std::string> strings;
+    const auto column = measurementColumn();
+    for (int ii = 0; ii < 32; ++ii) {
+        strings.insert(strings.end(), column.begin(), column.end());
+    }
+    const auto threads = static_cast<unsigned int>(state.range(0));
+    std::vector<precise_measurement> results;
+    for (auto _ : state) {
+        auto valid = measurement_from_string(strings, threads, results);
+        benchmark::DoNotOptimize(valid);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(strings.size()));
+}
+BENCHMARK(BM_measurementColumnThreads)
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime();
+
+// short compound strings which need no cleaning
+static void BM_cleanCompoundUnitFromString(benchmark::State& state)
+{
+    const std::vector<std::string> strings{
+        "kg*m/s^2", "J/(kg*K)", "lb/in^2", "mol/L", "W/m^2", "N*m"};
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto res = unit_from_string(strings[index]);
+        benchmark::DoNotOptimize(res);
+        if (++index == strings.size()) {
+            index = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_cleanCompoundUnitFromString);
+
+// the inputs from fuzzing which previously took a long time to parse
+static void BM_unitFromStringSlowInputs(benchmark::State& state)
+{
+    std::vector<std::string> strings;
+    for (int ii = 1; ii <= 40; ++ii) {
+        std::ifstream sfile(
+            BENCHMARK_FILE_FOLDER "/fuzz_issues/slow" + std::to_string(ii),
+            std::ios::binary);
+        if (sfile.is_open()) {
+            std::stringstream contents;
+            contents << sfile.rdbuf();
+            strings.push_back(contents.str());
+        }
+    }
+    if (strings.empty()) {
+        state.SkipWithError("fuzz files could not be loaded");
+        return;
+    }
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto res = unit_from_string(strings[index]);
+        benchmark::DoNotOptimize(res);
+        if (++index == strings.size()) {
+            index = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_unitFromStringSlowInputs);
+
+#ifndef UNITS_DISABLE_EXTRA_UNIT_STANDARDS
+// strings for the other unit standards
+static std::vector<std::string> r20Codes()
+{
+    std::vector<std::string> codes;
+#ifdef ENABLE_UNIT_MAP_ACCESS
+    using unitD = std::tuple<const char*, const char*, precise_unit>;
+    std::size_t size{0};
+    const auto* r20data =
+        reinterpret_cast<const unitD*>(detail::r20rawData(size));
+    for (std::size_t ii = 0; ii < size; ++ii) {
+        codes.emplace_back(std::get<0>(r20data[ii]));
+    }
+#else
+    codes = {"13",  "4W",  "A36", "AP", "B61", "C10", "C7",  "D12", "D88",
+             "E30", "E96", "F56", "G13", "G82", "H18", "H87", "J30", "K18",
+             "KD",  "L47", "LS",  "M7",  "MTR", "NA",  "P43", "PG",  "S8",
+             "WA"};
+#endif
+    return codes;
+}
+
+static const std::vector<std::string> x12Codes{
+    "03", "1Q", "48", "7C", "9Y", "AY", "BH", "BZ", "CI", "CZ",
+    "DU", "F6", "GA", "HK", "IM", "KH", "LR", "MP", "NJ", "OZ",
+    "PF", "Q4", "R9", "RU", "SL", "T4", "TN", "U5", "WD", "Y1"};
+
+static const std::vector<std::string> dodCodes{
+    "09", "45", "5I", "AC", "B2", "BI", "BY", "CE", "CV", "DO", "EJ",
+    "FM", "GX", "HR", "JG", "KU", "LT", "MJ", "ND", "OL", "PB", "PR",
+    "QU", "RP", "SF", "SV", "TC", "TS", "UQ", "WT", "Z2"};
+
+// cycle through a list of codes for one of the other unit standards
+template<typename Parser>
+static void parseCodes(
+    benchmark::State& state,
+    const std::vector<std::string>& codes,
+    Parser parser)
+{
+    if (codes.empty()) {
+        state.SkipWithError("no codes available");
+        return;
+    }
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto res = parser(codes[index]);
+        benchmark::DoNotOptimize(res);
+        if (++index == codes.size()) {
+            index = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_r20Unit(benchmark::State& state)
+{
+    parseCodes(state, r20Codes(), [](const std::string& code) {
+        return r20_unit(code);
+    });
+}
+BENCHMARK(BM_r20Unit);
+
+static void BM_x12Unit(benchmark::State& state)
+{
+    parseCodes(state, x12Codes, [](const std::string& code) {
+        return x12_unit(code);
+    });
+}
+BENCHMARK(BM_x12Unit);
+
+static void BM_dodUnit(benchmark::State& state)
+{
+    parseCodes(state, dodCodes, [](const std::string& code) {
+        return dod_unit(code);
+    });
+}
+BENCHMARK(BM_dodUnit);
+#endif
+
@@ -0,0 +1,103 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "webserver/response_template.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// count the allocations made while assembling the pages
+static std::uint64_t allocationCount{0};
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+// gcc flags the free in the replacement once it is inlined into a caller
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+static std::string loadPage()
+{
+    std::ifstream file(WEBSERVER_FILE_FOLDER "/convert.html");
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+// the search and replace the webserver used before the pages were split
+static void string_substitution(
+    std::string& page,
+    const std::vector<std::pair<std::string, std::string>>& subs)
+{
+    for (const auto& sub_pair : subs) {
+        auto loc = page.find(sub_pair.first);
+        while (loc != std::string::npos) {
+            page.replace(loc, sub_pair.first.size(), sub_pair.second);
+            loc = page.find(sub_pair.first);
+        }
+    }
+}
+
+static void BM_responseSubstitution(benchmark::State& state)
+{
+    const auto page = loadPage();
+    const auto start = allocationCount;
+    for (auto _ : state) {
+        std::vector<std::pair<std::string, std::string>> subs{
+            {"$M1$", "10 ft"},
+            {"$U1$", "m"},
+            {"$VALUE$", "3.048"},
+            {"$M2$", "10 ft"},
+            {"$U2$", "m"}};
+        auto response = page;
+        string_substitution(response, subs);
+        benchmark::DoNotOptimize(response.data());
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocationCount - start),
+        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_responseSubstitution);
+
+static void BM_responseTemplate(benchmark::State& state)
+{
+    const response_template page{loadPage()};
+    const auto start = allocationCount;
+    for (auto _ : state) {
+        auto response = page.render({{"10 ft", "m", "3.048", "10 ft", "m"}});
+        benchmark::DoNotOptimize(response.data());
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocationCount - start),
+        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_responseTemplate);
@@ -0,0 +1,119 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "bench_corpus.hpp"
+#include "units/units.hpp"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace units;
+
+// units with a direct name
+static void BM_namedUnitToString(benchmark::State& state)
+{
+    const std::vector<precise_unit> testUnits{
+        precise::m, precise::N, precise::J, precise::lb, precise::in};
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto str = to_string(testUnits[index]);
+        benchmark::DoNotOptimize(str);
+        if (++index == testUnits.size()) {
+            index = 0;
+        }
+    }
+}
+BENCHMARK(BM_namedUnitToString);
+
+// compound units with no direct name that require probing
+static void BM_compoundUnitToString(benchmark::State& state)
+{
+    const std::vector<precise_unit> testUnits{
+        precise::kg * precise::m.pow(3) / precise::s.pow(3) / precise::A,
+        precise::W / precise::m.pow(2) / precise::K,
+        precise_unit(37.5, precise::lb / precise::ft.pow(3)),
+        precise::mol / precise::kg / precise::s.pow(2),
+        precise::J / (precise::kg * precise::K) / precise::cd};
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto str = to_string(testUnits[index]);
+        benchmark::DoNotOptimize(str);
+        if (++index == testUnits.size()) {
+            index = 0;
+        }
+    }
+}
+BENCHMARK(BM_compoundUnitToString);
+
+// the same compound units with the output cache enabled
+static void BM_compoundUnitToStringCached(benchmark::State& state)
+{
+    const std::vector<precise_unit> testUnits{
+        precise::kg * precise::m.pow(3) / precise::s.pow(3) / precise::A,
+        precise::W / precise::m.pow(2) / precise::K,
+        precise_unit(37.5, precise::lb / precise::ft.pow(3)),
+        precise::mol / precise::kg / precise::s.pow(2),
+        precise::J / (precise::kg * precise::K) / precise::cd};
+    enableUnitOutputCache();
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto str = to_string(testUnits[index]);
+        benchmark::DoNotOptimize(str);
+        if (++index == testUnits.size()) {
+            index = 0;
+        }
+    }
+    disableUnitOutputCache();
+}
+BENCHMARK(BM_compoundUnitToStringCached);
+
+// measurements with a named unit and a compound unit
+static void BM_measurementToString(benchmark::State& state)
+{
+    const std::vector<precise_measurement> testMeasurements{
+        {12.5, precise::m},
+        {3.7e-5, precise::N},
+        {1200.0, precise::W / precise::m.pow(2) / precise::K},
+        {-40.0, precise::temperature::degF},
+        {0.25, precise::mol / precise::kg / precise::s.pow(2)}};
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto str = to_string(testMeasurements[index]);
+        benchmark::DoNotOptimize(str);
+        if (++index == testMeasurements.size()) {
+            index = 0;
+        }
+    }
+}
+BENCHMARK(BM_measurementToString);
+
+// the units produced by parsing each of the string corpora
+static void BM_corpusUnitToString(benchmark::State& state)
+{
+    std::vector<precise_unit> testUnits;
+    for (const auto& str :
+         bench::corpusStrings(static_cast<int>(state.range(0)))) {
+        auto unit = unit_from_string(str);
+        if (is_valid(unit)) {
+            testUnits.push_back(unit);
+        }
+    }
+    if (testUnits.empty()) {
+        state.SkipWithError("corpus file could not be loaded");
+        return;
+    }
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto str = to_string(testUnits[index]);
+        benchmark::DoNotOptimize(str);
+        if (++index == testUnits.size()) {
+            index = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(bench::corpusName(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_corpusUnitToString)->DenseRange(0, bench::corpusCount - 1);
@@ -0,0 +1,108 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "units/units.hpp"
+#include "units/units_conversion_maps.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace units;
+
+// all the strings in the defined unit tables
+static std::vector<std::string> definedStrings()
+{
+    std::vector<std::string> strings;
+    for (const auto& pr : defined_unit_strings_si) {
+        if (pr.first != nullptr && pr.first[0] != '\0') {
+            strings.emplace_back(pr.first);
+        }
+    }
+    for (const auto& pr : defined_unit_strings_customary) {
+        if (pr.first != nullptr && pr.first[0] != '\0') {
+            strings.emplace_back(pr.first);
+        }
+    }
+    return strings;
+}
+
+// the unordered_map previously used to store the defined unit strings as a
+// reference point for the lookup speed
+static void BM_referenceUnorderedMap(benchmark::State& state)
+{
+    std::unordered_map<std::string, precise_unit> map;
+    for (const auto& pr : defined_unit_strings_si) {
+        if (pr.first != nullptr) {
+            map.emplace(pr.first, pr.second);
+        }
+    }
+    for (const auto& pr : defined_unit_strings_customary) {
+        if (pr.first != nullptr) {
+            map.emplace(pr.first, pr.second);
+        }
+    }
+    auto strings = definedStrings();
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto fnd = map.find(strings[index]);
+        benchmark::DoNotOptimize(fnd);
+        if (++index == strings.size()) {
+            index = 0;
+        }
+    }
+}
+BENCHMARK(BM_referenceUnorderedMap);
+
+#ifdef ENABLE_UNIT_MAP_ACCESS
+// the flat table of defined unit strings used by the library
+static void BM_definedUnitTable(benchmark::State& state)
+{
+    auto strings = definedStrings();
+    std::size_t index{0};
+    for (auto _ : state) {
+        const auto* fnd = detail::lookupUnitString(
+            strings[index].c_str(), strings[index].size());
+        benchmark::DoNotOptimize(fnd);
+        if (++index == strings.size()) {
+            index = 0;
+        }
+    }
+}
+BENCHMARK(BM_definedUnitTable);
+#endif
+
+// lookup of strings that are directly defined through the public interface
+static void BM_definedUnitFromString(benchmark::State& state)
+{
+    auto strings = definedStrings();
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto un = unit_from_string(strings[index]);
+        benchmark::DoNotOptimize(un);
+        if (++index == strings.size()) {
+            index = 0;
+        }
+    }
+}
+BENCHMARK(BM_definedUnitFromString);
+
+// strings that are not in the tables and fall through the lookup
+static void BM_missingUnitFromString(benchmark::State& state)
+{
+    const std::vector<std::string> strings{
+        "kg*m/s^2", "J/(kg*K)", "lb/in^2", "km/h", "W/m^2"};
+    std::size_t index{0};
+    for (auto _ : state) {
+        auto un = unit_from_string(strings[index]);
+        benchmark::DoNotOptimize(un);
+        if (++index == strings.size()) {
+            index = 0;
+        }
+    }
+}
+BENCHMARK(BM_missingUnitFromString);
@@ -102,7 +102,7 @@ TEST_P(slowProblems, slowFiles)
     EXPECT_NO_THROW(unit_from_string(cdata));
 }
 
-INSTANTIATE_TEST_SUITE_P(slowFiles, slowProblems, ::testing::Range(1, 40));
+INSTANTIATE_TEST_SUITE_P(slowFiles, slowProblems, ::testing::Range(1, 41));
 
 class oomProblems : public ::testing::TestWithParam<int> {};
 
@@ -156,6 +156,24 @@ TEST(commodities, escapeStrings)
     clearCustomCommodities();
 }
 
+TEST(commodities, noInterning)
+{
+    auto hcode = getCommodity("grapes", no_commodity_interning);
+    EXPECT_NE(getCommodityName(hcode), "grapes");
+    EXPECT_EQ(getCommodity("grapes"), hcode);
+    EXPECT_EQ(getCommodityName(hcode), "grapes");
+
+    auto punit = unit_from_string("kg{lentils}", no_commodity_interning);
+    EXPECT_NE(punit.commodity(), 0U);
+    EXPECT_NE(getCommodityName(punit.commodity()), "lentils");
+    EXPECT_EQ(unit_from_string(to_string(punit)), punit);
+
+    hcode = getCommodity("lentils");
+    EXPECT_EQ(hcode, punit.commodity());
+    EXPECT_EQ(getCommodityName(hcode), "lentils");
+    clearCustomCommodities();
+}
+
 TEST(commodities, unusual2string)
 {
     precise_unit com(1.0, precise::kg.inv(), getCommodity("happy'u"));
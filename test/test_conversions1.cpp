@@ -8,6 +8,9 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "test.hpp"
 #include "units/units.hpp"
 
+#include <utility>
+#include <vector>
+
 static const double neg_forty_C = -40.0;
 static const double neg_forty_C_in_F = -40.0;
 static const double neg_forty_C_in_K = 233.15;
@@ -719,3 +722,117 @@ TEST(UnitDefinitions, unusualTemperature)
         325.0,
         1.0);
 }
+
+TEST(converter, kinds)
+{
+    using namespace units;
+    EXPECT_EQ(converter(m, ft).type(), converter::kind::linear);
+    EXPECT_EQ(converter(m, m).type(), converter::kind::linear);
+    EXPECT_EQ(converter(m, defunit).scale(), 1.0);
+    EXPECT_EQ(converter(degC, degF).type(), converter::kind::affine);
+    EXPECT_EQ(
+        converter(precise::pressure::psig, precise::pressure::psi).type(),
+        converter::kind::affine);
+    EXPECT_EQ(converter(Hz, s).type(), converter::kind::inverse);
+    EXPECT_EQ(converter(puOhm, puMW).type(), converter::kind::inverse);
+    EXPECT_EQ(
+        converter(precise::one, precise::log::neper).type(),
+        converter::kind::equation);
+    EXPECT_EQ(converter(m, lb).type(), converter::kind::invalid_conversion);
+    EXPECT_FALSE(converter(m, lb).is_valid());
+    EXPECT_TRUE(std::isnan(converter(m, lb)(2.0)));
+    EXPECT_FALSE(converter().is_valid());
+}
+
+TEST(converter, matchesConvert)
+{
+    using namespace units;
+    const std::vector<std::pair<precise_unit, precise_unit>> pairs{
+        {precise::m, precise::ft},
+        {precise::m, precise::m},
+        {precise::temperature::degC, precise::temperature::degF},
+        {precise::temperature::degF, precise::K},
+        {precise::K, precise::temperature::degF},
+        {precise::kilo * precise::temperature::degC,
+         precise::temperature::degF},
+        {precise::temperature::degR, precise::temperature::degC},
+        {precise::pressure::psig, precise::pressure::psi},
+        {precise::pressure::atm, precise::pressure::psig},
+        {precise_unit(2.0, precise::pressure::psig), precise::pressure::psig},
+        {precise::kilo * precise::Hz, precise::milli * precise::s},
+        {precise::electrical::puOhm, precise::electrical::puMW},
+        {precise::electrical::puA, precise::electrical::puMW},
+        {precise::electrical::puHz, precise::Hz},
+        {precise::N, precise::kg},
+        {precise::lbf, precise::kg},
+        {precise::mol, precise::count},
+        {precise::rpm, precise::rad / precise::s},
+        {precise::m.pow(3), precise::J},
+        {precise::one, precise::log::neper},
+        {precise::log::dB, precise::log::neper},
+        {precise::m, precise::lb}};
+    const std::vector<double> values{0.0, 1.0, -3.5, 27.4, 1e-4, 6.1e5};
+    for (const auto& pair : pairs) {
+        converter conv(pair.first, pair.second);
+        for (auto val : values) {
+            auto expected = convert(val, pair.first, pair.second);
+            auto actual = conv(val);
+            if (std::isnan(expected)) {
+                EXPECT_TRUE(std::isnan(actual))
+                    << to_string(pair.first) << "->" << to_string(pair.second);
+            } else if (std::isinf(expected)) {
+                EXPECT_EQ(actual, expected);
+            } else {
+                EXPECT_NEAR(
+                    actual,
+                    expected,
+                    std::abs(expected) * 1e-13 + 1e-12)
+                    << to_string(pair.first) << "->" << to_string(pair.second)
+                    << " for " << val;
+            }
+        }
+    }
+}
+
+TEST(converter, unitTypes)
+{
+    using namespace units;
+    converter conv(ft, precise::m);
+    EXPECT_NEAR(conv(10.0), convert(10.0, ft, precise::m), test::tolerance);
+    converter conv2(degF, degC);
+    EXPECT_NEAR(conv2(212.0), 100.0, test::tolerance);
+    EXPECT_NEAR(conv2(-40.0), -40.0, test::tolerance);
+}
+
+TEST(converter, arrays)
+{
+    using namespace units;
+    const std::vector<std::pair<precise_unit, precise_unit>> pairs{
+        {precise::ft, precise::m},
+        {precise::temperature::degF, precise::temperature::degC},
+        {precise::Hz, precise::milli * precise::s},
+        {precise::one, precise::log::neper},
+        {precise::m, precise::lb}};
+    std::vector<double> input(37);
+    for (std::size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<double>(ii) * 1.7 - 20.0;
+    }
+    std::vector<double> output(input.size());
+    for (const auto& pair : pairs) {
+        convert(
+            input.data(), output.data(), input.size(), pair.first, pair.second);
+        auto inplace = input;
+        convert(inplace.data(), inplace.size(), pair.first, pair.second);
+        for (std::size_t ii = 0; ii < input.size(); ++ii) {
+            auto expected = convert(input[ii], pair.first, pair.second);
+            if (std::isnan(expected)) {
+                EXPECT_TRUE(std::isnan(output[ii]));
+                EXPECT_TRUE(std::isnan(inplace[ii]));
+            } else {
+                EXPECT_NEAR(
+                    output[ii], expected, std::abs(expected) * 1e-13 + 1e-12);
+                EXPECT_EQ(inplace[ii], output[ii]);
+            }
+        }
+    }
+}
@@ -650,3 +650,74 @@ TEST(otherEqUnits, strings)
 }
 
 #endif
+
+TEST(equationArrays, matchScalar)
+{
+    const std::vector<double> input{
+        -12.5, -2.0, -0.5, 0.0, 1e-7, 0.25, 1.0, 3.7, 10.0, 45.0, 1e5};
+    std::vector<double> output(input.size());
+    const std::vector<precise_unit> baseUnits{
+        precise::one, precise::W, precise::V, precise::count.pow(-2)};
+    for (int eqType = 0; eqType < 32; ++eqType) {
+        for (const auto& base : baseUnits) {
+            auto eqUnit =
+                precise_unit(precise::custom::equation_unit(eqType)) * base;
+            const auto ubase = eqUnit.base_units();
+            precise::equations::convert_equnit_to_values(
+                input.data(), output.data(), input.size(), ubase);
+            for (std::size_t ii = 0; ii < input.size(); ++ii) {
+                auto expected = precise::equations::convert_equnit_to_value(
+                    input[ii], ubase);
+                if (std::isnan(expected)) {
+                    EXPECT_TRUE(std::isnan(output[ii]));
+                } else if (std::isinf(expected) || expected == 0.0) {
+                    EXPECT_EQ(output[ii], expected)
+                        << "eq type " << eqType << " value " << input[ii];
+                } else {
+                    // twice the bound documented for exp2Values, the scalar
+                    // functions are not exact either
+                    const double bound = std::ldexp(1.0, -51) *
+                        (4.0 + std::fabs(std::log2(std::fabs(expected))));
+                    EXPECT_NEAR(
+                        output[ii], expected, bound * std::fabs(expected))
+                        << "eq type " << eqType << " value " << input[ii];
+                }
+            }
+            precise::equations::convert_values_to_equnit(
+                input.data(), output.data(), input.size(), ubase);
+            for (std::size_t ii = 0; ii < input.size(); ++ii) {
+                auto expected = precise::equations::convert_value_to_equnit(
+                    input[ii], ubase);
+                if (std::isnan(expected)) {
+                    EXPECT_TRUE(std::isnan(output[ii]));
+                } else if (std::isinf(expected)) {
+                    EXPECT_EQ(output[ii], expected)
+                        << "eq type " << eqType << " value " << input[ii];
+                } else {
+                    // twice the bound documented for log2Values
+                    EXPECT_NEAR(
+                        output[ii],
+                        expected,
+                        std::ldexp(std::fabs(expected), -49))
+                        << "eq type " << eqType << " value " << input[ii];
+                }
+            }
+        }
+    }
+}
+
+TEST(equationArrays, converter)
+{
+    std::vector<double> values{-30.0, -3.0, 0.0, 2.5, 17.0, 60.0};
+    const precise_unit dBm = precise::log::dB * precise::milli * precise::W;
+    const precise_unit neperW = precise::log::neper * precise::W;
+    auto expected = values;
+    for (auto& val : expected) {
+        val = convert(val, dBm, neperW);
+    }
+    convert(values.data(), values.size(), dBm, neperW);
+    for (std::size_t ii = 0; ii < values.size(); ++ii) {
+        // a relative error in the power is an absolute error in the log
+        EXPECT_NEAR(values[ii], expected[ii], 1e-13);
+    }
+}
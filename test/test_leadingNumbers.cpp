@@ -8,6 +8,8 @@ SPDX-License-Identifier: BSD-3-Clause
 #include "units/units.hpp"
 
 #include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -194,6 +196,50 @@ TEST(leadingNumbers, edgeCases)
     EXPECT_EQ(res, 0.0);
 }
 
+TEST(leadingNumbers, decimalForms)
+{
+    // the conversions should match the correctly rounded strtod result
+    const std::vector<std::string> numbers{
+        "0.1",
+        "123456789012345678",
+        "9007199254740993",
+        "1.7976931348623157e308",
+        "2.2250738585072014e-308",
+        "0.000000000000000000000000000123",
+        "3.14159265358979323846264338327950288",
+        "1e23",
+        "8.41e21",
+        "4.9e-324",
+        "1.e5",
+        ".25e-2",
+        "000012.5000"};
+    for (const auto& number : numbers) {
+        size_t index{0};
+        auto res = testLeadingNumber(number, index);
+        auto expected = std::strtod(number.c_str(), nullptr);
+        if (std::fabs(expected) < std::numeric_limits<double>::min()) {
+            expected = 0.0;
+        }
+        EXPECT_EQ(res, expected) << number;
+        EXPECT_EQ(index, number.size()) << number;
+    }
+    size_t index{0};
+    auto res = testLeadingNumber("2.5e", index);
+    EXPECT_EQ(res, 2.5);
+    EXPECT_EQ(index, 3U);
+
+    res = testLeadingNumber("-4E+2m", index);
+    EXPECT_EQ(res, -400.0);
+    EXPECT_EQ(index, 5U);
+
+    res = testLeadingNumber("1e400", index);
+    EXPECT_TRUE(std::isinf(res));
+
+    res = testLeadingNumber("-0.0", index);
+    EXPECT_EQ(res, 0.0);
+    EXPECT_FALSE(std::signbit(res));
+}
+
 TEST(numericalWords, simple)
 {
     size_t index{0U};
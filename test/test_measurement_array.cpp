@@ -0,0 +1,157 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "test.hpp"
+#include "units/measurement_array.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace units;
+
+TEST(measurementArray, construction)
+{
+    measurement_array arr(3, 2.0, precise::m);
+    EXPECT_EQ(arr.size(), 3U);
+    EXPECT_EQ(arr[1], precise_measurement(2.0, precise::m));
+    EXPECT_EQ(arr.units(), precise::m);
+
+    std::vector<precise_measurement> meas{
+        {1.0, precise::m}, {2.0, precise::km}, {100.0, precise::cm}};
+    measurement_array arr2(meas, precise::m);
+    ASSERT_EQ(arr2.size(), 3U);
+    EXPECT_DOUBLE_EQ(arr2.values()[1], 2000.0);
+    EXPECT_DOUBLE_EQ(arr2.values()[2], 1.0);
+
+    arr2.push_back(precise_measurement(3.0, precise::mm));
+    EXPECT_DOUBLE_EQ(arr2.values()[3], 0.003);
+    arr2.push_back(5.0);
+    EXPECT_EQ(arr2[4], precise_measurement(5.0, precise::m));
+    EXPECT_THROW(arr2.at(5), std::out_of_range);
+}
+
+TEST(measurementArray, convert)
+{
+    measurement_array arr({1.0, 2.5, -4.0}, precise::ft);
+    auto conv = arr.convert_to(precise::in);
+    EXPECT_EQ(conv.units(), precise::in);
+    for (std::size_t ii = 0; ii < arr.size(); ++ii) {
+        EXPECT_DOUBLE_EQ(conv.values()[ii], arr[ii].value_as(precise::in));
+    }
+
+    measurement_array temps({0.0, 100.0, -40.0}, precise::degC);
+    temps.convert_in_place(precise::degF);
+    EXPECT_EQ(temps.units(), precise::degF);
+    EXPECT_NEAR(temps.values()[0], 32.0, 1e-9);
+    EXPECT_NEAR(temps.values()[1], 212.0, 1e-9);
+    EXPECT_NEAR(temps.values()[2], -40.0, 1e-9);
+}
+
+TEST(measurementArray, arrayOps)
+{
+    measurement_array arr1({1.0, 2.0, 3.0}, precise::m);
+    measurement_array arr2({10.0, 20.0, 30.0}, precise::cm);
+
+    auto sum = arr1 + arr2;
+    EXPECT_EQ(sum.units(), precise::m);
+    EXPECT_DOUBLE_EQ(sum.values()[0], 1.1);
+    EXPECT_DOUBLE_EQ(sum.values()[2], 3.3);
+
+    auto diff = arr1 - arr2;
+    EXPECT_DOUBLE_EQ(diff.values()[1], 1.8);
+
+    auto prod = arr1 * arr2;
+    EXPECT_EQ(prod.units(), precise::m * precise::cm);
+    EXPECT_DOUBLE_EQ(prod.values()[2], 90.0);
+
+    auto rat = arr1 / arr2;
+    EXPECT_EQ(rat.units(), precise::m / precise::cm);
+    EXPECT_DOUBLE_EQ(rat.values()[1], 0.1);
+
+    measurement_array temps({10.0, 20.0, 30.0}, precise::degC);
+    measurement_array ftemps({50.0, 68.0, 86.0}, precise::degF);
+    auto tsum = temps + ftemps;
+    EXPECT_NEAR(tsum.values()[0], 20.0, 1e-9);
+    EXPECT_NEAR(tsum.values()[2], 60.0, 1e-9);
+
+    measurement_array short_array(2, 1.0, precise::m);
+    EXPECT_THROW(arr1 + short_array, std::invalid_argument);
+    EXPECT_THROW(arr1 * short_array, std::invalid_argument);
+}
+
+TEST(measurementArray, scalarOps)
+{
+    measurement_array arr({1.0, 2.0, 4.0}, precise::m);
+
+    auto sum = arr + precise_measurement(50.0, precise::cm);
+    EXPECT_DOUBLE_EQ(sum.values()[0], 1.5);
+    auto diff = arr - precise_measurement(1.0, precise::m);
+    EXPECT_DOUBLE_EQ(diff.values()[2], 3.0);
+
+    auto scaled = 2.0 * arr;
+    EXPECT_EQ(scaled.units(), precise::m);
+    EXPECT_DOUBLE_EQ(scaled.values()[1], 4.0);
+    auto half = arr / 2.0;
+    EXPECT_DOUBLE_EQ(half.values()[2], 2.0);
+
+    auto speed = arr / precise_measurement(2.0, precise::s);
+    EXPECT_EQ(speed.units(), precise::m / precise::s);
+    EXPECT_DOUBLE_EQ(speed.values()[2], 2.0);
+    auto force = arr * precise_measurement(3.0, precise::N);
+    EXPECT_EQ(force.units(), precise::m * precise::N);
+    EXPECT_DOUBLE_EQ(force.values()[0], 3.0);
+
+    auto area = arr * precise::m;
+    EXPECT_EQ(area.units(), precise::m.pow(2));
+    EXPECT_DOUBLE_EQ(area.values()[1], 2.0);
+    auto freq = arr / precise::s;
+    EXPECT_EQ(freq.units(), precise::m / precise::s);
+
+    arr *= 3.0;
+    EXPECT_DOUBLE_EQ(arr.values()[0], 3.0);
+    arr += precise_measurement(1.0, precise::km);
+    EXPECT_DOUBLE_EQ(arr.values()[0], 1003.0);
+}
+
+TEST(measurementArray, reductions)
+{
+    measurement_array arr({3.0, -1.0, 7.0, 5.0}, precise::kg);
+    EXPECT_EQ(arr.sum(), precise_measurement(14.0, precise::kg));
+    EXPECT_EQ(arr.mean(), precise_measurement(3.5, precise::kg));
+    EXPECT_EQ(arr.min(), precise_measurement(-1.0, precise::kg));
+    EXPECT_EQ(arr.max(), precise_measurement(7.0, precise::kg));
+
+    measurement_array empty_array(precise::kg);
+    EXPECT_TRUE(empty_array.empty());
+    EXPECT_EQ(empty_array.sum().value(), 0.0);
+    EXPECT_TRUE(std::isnan(empty_array.mean().value()));
+}
+
+TEST(measurementArray, views)
+{
+    std::vector<double> raw{1.0, 2.0, 3.0, 4.0};
+    measurement_array_view view(raw.data(), raw.size(), precise::s);
+    EXPECT_EQ(view.data(), raw.data());
+    EXPECT_EQ(view[2], precise_measurement(3.0, precise::s));
+    EXPECT_EQ(view.sum(), precise_measurement(10.0, precise::s));
+
+    auto sub = view.subview(1, 2);
+    EXPECT_EQ(sub.size(), 2U);
+    EXPECT_EQ(sub.data(), raw.data() + 1);
+    EXPECT_EQ(sub.max(), precise_measurement(3.0, precise::s));
+    EXPECT_EQ(view.subview(3, 10).size(), 1U);
+    EXPECT_TRUE(view.subview(10, 1).empty());
+
+    auto ms = sub.convert_to(precise::ms);
+    EXPECT_DOUBLE_EQ(ms.values()[0], 2000.0);
+
+    measurement_array arr({5.0, 6.0}, precise::m);
+    measurement_array_view arr_view = arr;
+    EXPECT_EQ(arr_view.data(), arr.data());
+    auto doubled = arr + arr.view();
+    EXPECT_DOUBLE_EQ(doubled.values()[1], 12.0);
+}
@@ -67,6 +67,63 @@ TEST(MeasurementStrings, interesting)
     EXPECT_EQ(pm.as_unit(), precise::nano * precise::m);
 }
 
+TEST(MeasurementStrings, batch)
+{
+    const std::vector<std::string> strings{
+        "12.5 kg",
+        "13.1 kg",
+        "9.7 lb",
+        "",
+        "345 blarg",
+        "$9.99",
+        "14 kg",
+        "nanometre",
+        "2.5"};
+    std::vector<precise_measurement> results;
+    auto valid = measurement_from_string(strings, results);
+    ASSERT_EQ(results.size(), strings.size());
+    ASSERT_EQ(valid.size(), strings.size());
+    for (std::size_t ii = 0; ii < strings.size(); ++ii) {
+        auto expected = measurement_from_string(strings[ii]);
+        EXPECT_EQ(results[ii].value(), expected.value()) << strings[ii];
+        if (valid[ii]) {
+            EXPECT_EQ(results[ii].units(), expected.units()) << strings[ii];
+        }
+    }
+    EXPECT_FALSE(is_valid(results[4].units()));
+    EXPECT_EQ(results[1], 13.1 * precise::kg);
+    EXPECT_TRUE(valid[0]);
+    EXPECT_TRUE(valid[2]);
+    EXPECT_FALSE(valid[3]);
+    EXPECT_FALSE(valid[4]);
+    EXPECT_TRUE(valid[5]);
+    EXPECT_TRUE(valid[8]);
+}
+
+TEST(MeasurementStrings, batchThreads)
+{
+    const std::vector<std::string> units{"kg", "lb", "m/s", "blarg", "kWh"};
+    std::vector<std::string> strings;
+    for (int ii = 0; ii < 500; ++ii) {
+        strings.push_back(
+            std::to_string(ii) + ' ' + units[ii % units.size()]);
+    }
+    std::vector<precise_measurement> expected;
+    auto expectedValid = measurement_from_string(strings, expected);
+    for (unsigned int threads : {0U, 1U, 3U, 8U}) {
+        std::vector<precise_measurement> results;
+        auto valid = measurement_from_string(strings, threads, results);
+        ASSERT_EQ(results.size(), strings.size());
+        EXPECT_EQ(valid, expectedValid) << threads;
+        for (std::size_t ii = 0; ii < strings.size(); ++ii) {
+            EXPECT_EQ(results[ii].value(), expected[ii].value());
+            if (valid[ii]) {
+                EXPECT_EQ(results[ii].units(), expected[ii].units());
+            }
+        }
+    }
+}
+
 TEST(MeasurementToString, simple)
 {
     auto pm = precise_measurement(45.0, precise::m);
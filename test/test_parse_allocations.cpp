@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "units/units.hpp"
+
+#include "test.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+
+// count the heap allocations made while a test is actively counting
+static std::atomic<bool> countAllocations{false};
+static std::atomic<long> allocationCount{0};
+
+void* operator new(std::size_t size)
+{
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        ++allocationCount;
+    }
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+using namespace units;
+
+static long parseAllocations(const std::string& test, precise_unit& result)
+{
+    std::string ustring = test;
+    allocationCount.store(0);
+    countAllocations.store(true);
+    result = unit_from_string(std::move(ustring));
+    countAllocations.store(false);
+    return allocationCount.load();
+}
+
+TEST(parseAllocations, compoundUnits)
+{
+    precise_unit result;
+    EXPECT_EQ(parseAllocations("kg*m/s^2", result), 0);
+    EXPECT_EQ(result, precise::N);
+    EXPECT_EQ(parseAllocations("J/(kg*K)", result), 0);
+    EXPECT_EQ(result, precise::J / (precise::kg * precise::K));
+    EXPECT_EQ(parseAllocations("lb/in^2", result), 0);
+    EXPECT_EQ(result, precise::lb / precise::in.pow(2));
+    EXPECT_EQ(parseAllocations("mol/L", result), 0);
+    EXPECT_EQ(result, precise::mol / precise::L);
+}
+
+TEST(parseAllocations, longUnits)
+{
+    precise_unit result;
+    EXPECT_LE(parseAllocations("kilogram*meter/second^2", result), 1);
+    EXPECT_EQ(result, precise::N);
+    EXPECT_LE(parseAllocations("meter/second", result), 1);
+    EXPECT_EQ(result, precise::m / precise::s);
+}
@@ -0,0 +1,153 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+
+/** @file stress tests of the global state used while parsing, these are most
+useful when built with -fsanitize=thread*/
+
+#include "test.hpp"
+#include "units/units.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace units;
+
+static const precise_unit blorp(17.2, precise::m * precise::kg);
+
+TEST(threadSafety, userDefinedUnits)
+{
+    std::atomic<bool> done{false};
+    std::atomic<int> found{0};
+    std::vector<std::thread> readers;
+    for (int ii = 0; ii < 4; ++ii) {
+        readers.emplace_back([&done, &found, ii]() {
+            const std::string name = "blorp" + std::to_string(ii % 2);
+            while (!done.load()) {
+                auto un = unit_from_string(name + "/s");
+                if (is_valid(un)) {
+                    EXPECT_EQ(un, blorp / precise::s);
+                    ++found;
+                }
+                auto str = to_string(blorp * precise::s);
+                EXPECT_FALSE(str.empty());
+            }
+        });
+    }
+    std::thread writer([&done]() {
+        for (int ii = 0; ii < 400; ++ii) {
+            addUserDefinedUnit("blorp" + std::to_string(ii % 2), blorp);
+            addUserDefinedInputUnit("flarp" + std::to_string(ii % 7), blorp);
+            addUserDefinedOutputUnit("flarp", blorp * precise::s);
+            removeUserDefinedUnit("blorp" + std::to_string((ii + 1) % 2));
+            if (ii % 50 == 49) {
+                clearUserDefinedUnits();
+            }
+        }
+        done.store(true);
+    });
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    addUserDefinedUnit("blorp0", blorp);
+    EXPECT_EQ(unit_from_string("blorp0/s"), blorp / precise::s);
+    clearUserDefinedUnits();
+    EXPECT_FALSE(is_valid(unit_from_string("blorp0")));
+}
+
+TEST(threadSafety, batchWithSettingChanges)
+{
+    std::vector<std::string> strings;
+    const std::vector<std::string> units{
+        "kg{wheat}/acre", "m/s", "lb{custom commodity}", "kWh", "ft"};
+    for (int ii = 0; ii < 2000; ++ii) {
+        strings.push_back(
+            std::to_string(ii) + ' ' + units[ii % units.size()]);
+    }
+    std::thread writer([]() {
+        for (int ii = 0; ii < 200; ++ii) {
+            auto domain = setUnitsDomain(
+                (ii % 2 == 0) ? domains::ucum : domains::defaultDomain);
+            setDefaultFlags(getDefaultFlags());
+            setUnitsDomain(domain);
+        }
+    });
+    std::vector<precise_measurement> results;
+    auto valid = measurement_from_string(strings, 4U, results);
+    writer.join();
+    ASSERT_EQ(valid.size(), strings.size());
+    for (std::size_t ii = 1; ii < strings.size(); ii += units.size()) {
+        EXPECT_TRUE(valid[ii]);
+        EXPECT_EQ(results[ii].units(), precise::m / precise::s);
+    }
+    setUnitsDomain(domains::defaultDomain);
+}
+
+TEST(threadSafety, parseContexts)
+{
+    parse_context cooking(domains::cooking);
+    cooking.add_unit("blorp", blorp);
+    parse_context standard;
+    standard.add_commodity("flarp", 4545U);
+    standard.enable_cache(16);
+    std::vector<std::thread> parsers;
+    for (int ii = 0; ii < 4; ++ii) {
+        parsers.emplace_back([&cooking, &standard]() {
+            for (int jj = 0; jj < 200; ++jj) {
+                EXPECT_EQ(unit_from_string(cooking, "C"), precise::us::cup);
+                EXPECT_EQ(unit_from_string(cooking, "blorp"), blorp);
+                EXPECT_EQ(unit_from_string(standard, "C"), precise::C);
+                EXPECT_EQ(
+                    unit_from_string(standard, "lb{flarp}").commodity(),
+                    4545U);
+                EXPECT_FALSE(is_valid(unit_from_string(standard, "blorp")));
+            }
+        });
+    }
+    for (auto& parser : parsers) {
+        parser.join();
+    }
+}
+
+TEST(threadSafety, commodities)
+{
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int ii = 0; ii < 4; ++ii) {
+        readers.emplace_back([&done, ii]() {
+            int jj{0};
+            while (!done.load()) {
+                const std::string name =
+                    "generated commodity " + std::to_string(ii * 1000 + jj);
+                auto code = getCommodity(name);
+                auto found = getCommodityName(code);
+                EXPECT_FALSE(found.empty());
+                auto custom = getCommodity("threadcustom");
+                EXPECT_FALSE(getCommodityName(custom).empty());
+                jj = (jj + 1) % 500;
+            }
+        });
+    }
+    std::thread writer([&done]() {
+        for (int ii = 0; ii < 200; ++ii) {
+            addCustomCommodity("threadcustom", 7171U);
+            addCustomCommodity("other" + std::to_string(ii % 9), 7200U + ii);
+            if (ii % 20 == 19) {
+                clearCustomCommodities();
+            }
+        }
+        done.store(true);
+    });
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    clearCustomCommodities();
+    EXPECT_NE(getCommodity("threadcustom"), 7171U);
+}
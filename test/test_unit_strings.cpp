@@ -1698,6 +1698,264 @@ TEST(userDefinedUnits, badDefinitions)
     EXPECT_EQ(cnt, 5);
 }
 
+TEST(stringCache, hitsAndMisses)
+{
+    enableUnitStringCache(64);
+    auto u1 = unit_from_string("kg*m/s^2");
+    auto u2 = unit_from_string("kg*m/s^2");
+    EXPECT_EQ(u1, precise::N);
+    EXPECT_EQ(u2, u1);
+    auto u3 = unit_from_string("kg*m/s^2", strict_ucum);
+    EXPECT_EQ(u3, u1);
+    auto stats = getUnitStringCacheStatistics();
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.misses, 2U);
+    EXPECT_EQ(stats.size, 2U);
+    EXPECT_GE(stats.capacity, 64U);
+
+    clearUnitStringCache();
+    stats = getUnitStringCacheStatistics();
+    EXPECT_EQ(stats.hits, 0U);
+    EXPECT_EQ(stats.size, 0U);
+    disableUnitStringCache();
+    EXPECT_EQ(getUnitStringCacheStatistics().capacity, 0U);
+}
+
+TEST(stringCache, bounded)
+{
+    enableUnitStringCache(16);
+    for (int ii = 0; ii < 200; ++ii) {
+        auto un = unit_from_string(std::to_string(ii) + "m");
+        EXPECT_EQ(un, precise_unit(ii, precise::m));
+    }
+    auto stats = getUnitStringCacheStatistics();
+    EXPECT_LE(stats.size, stats.capacity);
+    EXPECT_EQ(stats.misses, 200U);
+    disableUnitStringCache();
+}
+
+TEST(stringCache, invalidation)
+{
+    enableUnitStringCache();
+    EXPECT_FALSE(is_valid(unit_from_string("cachgit")));
+    precise_unit cachgit(4.754, mol / m.pow(2));
+    addUserDefinedUnit("cachgit", cachgit);
+    EXPECT_EQ(unit_from_string("cachgit"), cachgit);
+    removeUserDefinedUnit("cachgit");
+    EXPECT_FALSE(is_valid(unit_from_string("cachgit")));
+
+    EXPECT_EQ(unit_from_string("C"), precise::C);
+    auto pdomain = setUnitsDomain(domains::cooking);
+    EXPECT_EQ(unit_from_string("C"), precise::us::cup);
+    setUnitsDomain(pdomain);
+    EXPECT_EQ(unit_from_string("C"), precise::C);
+
+    addCustomCommodity("cachecommodity", 77);
+    EXPECT_EQ(unit_from_string("kg{cachecommodity}").commodity(), 77U);
+    clearCustomCommodities();
+    EXPECT_NE(unit_from_string("kg{cachecommodity}").commodity(), 77U);
+    disableUnitStringCache();
+}
+
+TEST(outputCache, hitsAndMisses)
+{
+    enableUnitOutputCache(64);
+    auto un = precise::W / precise::m.pow(2) / precise::K;
+    auto str1 = to_string(un);
+    auto str2 = to_string(un);
+    EXPECT_EQ(str1, "W*m^-2*K^-1");
+    EXPECT_EQ(str2, str1);
+    EXPECT_EQ(to_string(precise::N), "N");
+    // the commodity is part of the key
+    EXPECT_EQ(to_string(precise::kg * precise::currency), "kg*$");
+    auto stats = getUnitOutputCacheStatistics();
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.misses, 3U);
+    EXPECT_EQ(stats.size, 3U);
+
+    clearUnitOutputCache();
+    stats = getUnitOutputCacheStatistics();
+    EXPECT_EQ(stats.hits, 0U);
+    EXPECT_EQ(stats.size, 0U);
+    disableUnitOutputCache();
+    EXPECT_EQ(getUnitOutputCacheStatistics().capacity, 0U);
+}
+
+TEST(outputCache, invalidation)
+{
+    enableUnitOutputCache();
+    precise_unit idgit(4.754, mol / m.pow(2));
+    auto str = to_string(idgit);
+    EXPECT_NE(str, "idgit");
+    addUserDefinedOutputUnit("idgit", idgit);
+    EXPECT_EQ(to_string(idgit), "idgit");
+    clearUserDefinedUnits();
+    EXPECT_EQ(to_string(idgit), str);
+
+    addUserDefinedUnit("idgit", idgit);
+    EXPECT_EQ(to_string(idgit), "idgit");
+    removeUserDefinedUnit("idgit");
+    EXPECT_EQ(to_string(idgit), str);
+
+    precise_unit commUnit(precise::kg, 7135U);
+    auto cstr = to_string(commUnit);
+    addCustomCommodity("cachedcomm", 7135U);
+    EXPECT_EQ(to_string(commUnit), "kg{cachedcomm}");
+    clearCustomCommodities();
+    EXPECT_EQ(to_string(commUnit), cstr);
+    disableUnitOutputCache();
+}
+
+TEST(domainUnits, sortedTables)
+{
+    const std::vector<std::uint64_t> domainList{
+        domains::ucum,
+        domains::cooking,
+        domains::nuclear,
+        domains::surveying,
+        domains::astronomy,
+        domains::climate,
+        domains::us_customary,
+        domains::allDomains};
+    for (auto domain : domainList) {
+        auto names = detail::testing::testDomainUnitNames(domain);
+        ASSERT_FALSE(names.empty()) << "domain " << domain;
+        EXPECT_TRUE(std::is_sorted(names.begin(), names.end()))
+            << "domain " << domain;
+        for (const auto& name : names) {
+            EXPECT_TRUE(
+                is_valid(detail::testing::testDomainUnit(domain, name)))
+                << name << " in domain " << domain;
+        }
+    }
+    EXPECT_TRUE(detail::testing::testDomainUnitNames(0).empty());
+}
+
+TEST(domainUnits, noCrossDomainCollisions)
+{
+    const std::vector<std::uint64_t> domainList{
+        domains::ucum,
+        domains::cooking,
+        domains::nuclear,
+        domains::surveying,
+        domains::astronomy,
+        domains::climate,
+        domains::us_customary,
+        domains::allDomains};
+    for (auto domain : domainList) {
+        for (auto other : domainList) {
+            if (other == domain) {
+                continue;
+            }
+            auto otherNames = detail::testing::testDomainUnitNames(other);
+            for (const auto& name :
+                 detail::testing::testDomainUnitNames(domain)) {
+                if (std::find(otherNames.begin(), otherNames.end(), name) ==
+                    otherNames.end()) {
+                    EXPECT_FALSE(is_valid(
+                        detail::testing::testDomainUnit(other, name)))
+                        << name << " from domain " << domain
+                        << " found in domain " << other;
+                }
+            }
+        }
+        // no unit is defined for domains without a table
+        for (const auto& name : detail::testing::testDomainUnitNames(domain)) {
+            EXPECT_FALSE(is_valid(detail::testing::testDomainUnit(0, name)));
+            EXPECT_FALSE(is_valid(detail::testing::testDomainUnit(2, name)));
+        }
+    }
+    EXPECT_EQ(
+        detail::testing::testDomainUnit(domains::cooking, "C"),
+        precise::us::cup);
+    EXPECT_EQ(
+        detail::testing::testDomainUnit(domains::surveying, u8"\u2033"),
+        precise::us::inch);
+}
+
+TEST(parseContext, domain)
+{
+    parse_context cooking(domains::cooking);
+    parse_context standard;
+    EXPECT_EQ(unit_from_string(cooking, "C"), precise::us::cup);
+    EXPECT_EQ(unit_from_string(standard, "C"), precise::C);
+    EXPECT_EQ(unit_from_string("C"), precise::C);
+    // a domain in the flags takes precedence
+    EXPECT_EQ(unit_from_string(cooking, "C", strict_ucum), precise::C);
+    parse_context astronomy(domains::astronomy);
+    auto meas = measurement_from_string(astronomy, "3 year");
+    EXPECT_EQ(meas.units(), precise::time::at);
+    EXPECT_EQ(meas.value(), 3.0);
+    EXPECT_EQ(measurement_from_string("3 year").units(), precise::time::yr);
+}
+
+TEST(parseContext, userDefinedUnits)
+{
+    precise_unit zorbflux(3.71, mol / m.pow(2));
+    parse_context context;
+    context.add_unit("zorbflux", zorbflux);
+    EXPECT_EQ(unit_from_string(context, "zorbflux"), zorbflux);
+    EXPECT_EQ(unit_from_string(context, "zorbflux/s"), zorbflux / precise::s);
+    EXPECT_EQ(to_string(context, zorbflux), "zorbflux");
+    EXPECT_FALSE(is_valid(unit_from_string("zorbflux")));
+
+    // the global units are not used with a context
+    addUserDefinedUnit("globalunit", zorbflux * precise::kg);
+    EXPECT_FALSE(is_valid(unit_from_string(context, "globalunit")));
+    clearUserDefinedUnits();
+
+    // copies are independent once modified
+    auto copy = context;
+    copy.remove_unit("zorbflux");
+    EXPECT_FALSE(is_valid(unit_from_string(copy, "zorbflux")));
+    EXPECT_EQ(unit_from_string(context, "zorbflux"), zorbflux);
+
+    context.add_input_unit("zorbin", zorbflux * precise::m);
+    context.add_output_unit("zorbout", zorbflux * precise::m);
+    EXPECT_EQ(unit_from_string(context, "zorbin"), zorbflux * precise::m);
+    EXPECT_FALSE(is_valid(unit_from_string(context, "zorbout")));
+    EXPECT_EQ(to_string(context, zorbflux * precise::m), "zorbout");
+    context.clear_units();
+    EXPECT_FALSE(is_valid(unit_from_string(context, "zorbflux")));
+}
+
+TEST(parseContext, commodities)
+{
+    parse_context context;
+    context.add_commodity("Ctxcommodity", 8181U);
+    auto un = unit_from_string(context, "kg{ctxcommodity}");
+    EXPECT_EQ(un.commodity(), 8181U);
+    EXPECT_EQ(to_string(context, un), "kg{ctxcommodity}");
+    EXPECT_NE(unit_from_string("kg{ctxcommodity}").commodity(), 8181U);
+
+    addCustomCommodity("globalcommodity", 8282U);
+    EXPECT_NE(
+        unit_from_string(context, "kg{globalcommodity}").commodity(), 8282U);
+    clearCustomCommodities();
+    context.clear_commodities();
+    EXPECT_NE(unit_from_string(context, "kg{ctxcommodity}").commodity(), 8181U);
+}
+
+TEST(parseContext, cache)
+{
+    parse_context context;
+    context.enable_cache(64);
+    EXPECT_EQ(unit_from_string(context, "kg*m/s^2"), precise::N);
+    EXPECT_EQ(unit_from_string(context, "kg*m/s^2"), precise::N);
+    auto stats = context.get_cache_statistics();
+    EXPECT_EQ(stats.hits, 1U);
+    EXPECT_EQ(stats.misses, 1U);
+
+    // modifying the context discards the cached results
+    EXPECT_FALSE(is_valid(unit_from_string(context, "cachectx")));
+    context.add_unit("cachectx", precise::N * precise::m);
+    EXPECT_EQ(unit_from_string(context, "cachectx"), precise::J);
+    EXPECT_EQ(context.get_cache_statistics().hits, 0U);
+
+    context.disable_cache();
+    EXPECT_EQ(context.get_cache_statistics().capacity, 0U);
+}
+
 TEST(defaultUnits, unitTypes)
 {
     EXPECT_EQ(default_unit("impedance quantity"), precise::ohm);
@@ -1871,6 +2129,20 @@ TEST(stringGeneration, test1)
     EXPECT_EQ(res, "157.1s^-3");
 }
 
+TEST(stringCleanup, classification)
+{
+    using detail::testing::testClassifyUnitString;
+    EXPECT_EQ(testClassifyUnitString("kg/s"), 0U);
+    EXPECT_EQ(testClassifyUnitString("kg s"), detail::whitespace_chars);
+    EXPECT_EQ(
+        testClassifyUnitString("kg\xC2\xB7m"), detail::non_ascii_chars);
+    EXPECT_EQ(testClassifyUnitString("m&deg;"), detail::html_chars);
+    EXPECT_EQ(testClassifyUnitString("kg{wheat}"), detail::bracket_chars);
+    EXPECT_EQ(
+        testClassifyUnitString("10*3.m"),
+        detail::digit_chars | detail::dot_chars | detail::multiply_chars);
+}
+
 TEST(stringCleanup, testZstrings)
 {
     auto res = detail::testing::testCleanUpString("0.000000045lb", 0);
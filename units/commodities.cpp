@@ -13,10 +13,14 @@ SPDX-License-Identifier: BSD-3-Clause
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 /*
 // https://en.wikipedia.org/wiki/List_of_traded_commodities
@@ -205,18 +209,198 @@ uint32_t stringHash(const std::string& str)
     return hash;  // or return h % C;
 }
 
+namespace detail {
+    // defined in units.cpp
+    void invalidateStringParseCache();
+    void invalidateUnitOutputCache();
+    bool contextCommodity(const std::string& comm, std::uint32_t& code);
+    bool contextCommodityName(std::uint32_t code, std::string& name);
+}  // namespace detail
+
 static std::atomic<bool> allowCustomCommodities{true};
 
 void disableCustomCommodities()
 {
     allowCustomCommodities.store(false);
+    detail::invalidateStringParseCache();
+    detail::invalidateUnitOutputCache();
 }
 void enableCustomCommodities()
 {
     allowCustomCommodities.store(true);
+    detail::invalidateStringParseCache();
+    detail::invalidateUnitOutputCache();
+}
+namespace {
+    /// commodities added with addCustomCommodity
+    struct custom_commodities {
+        commodities::commodityNameMap codes;
+        std::unordered_map<std::uint32_t, std::string> names;
+    };
+
+    /** a fixed size table of the names of commodities with generated codes
+    @details lookups never lock. A name is added by claiming an empty slot
+    with a compare and swap and is never modified after that. If all the
+    slots a code can use are taken the name is not stored, so adversarial
+    input cannot grow the table without bound. Entries removed by clear are
+    freed once no reader can still be using them*/
+    class commodity_name_table {
+      public:
+        ~commodity_name_table()
+        {
+            for (auto& slot : slots) {
+                delete slot.load(std::memory_order_acquire);
+            }
+        }
+        /// get the name stored for a code, returns false if there is none
+        bool find(std::uint32_t code, std::string& name) const
+        {
+            const detail::snapshot_read_scope scope;
+            for (std::size_t ii = 0; ii < maxProbes; ++ii) {
+                const auto* entry =
+                    slots[slotIndex(code, ii)].load(std::memory_order_acquire);
+                if (entry == nullptr) {
+                    return false;
+                }
+                if (entry->code == code) {
+                    name = entry->name;
+                    return true;
+                }
+            }
+            return false;
+        }
+        /// store a name for a code, returns true if the name was stored
+        bool insert(std::uint32_t code, const std::string& name)
+        {
+            if (name.size() > maxNameLength) {
+                return false;
+            }
+            name_entry* newEntry{nullptr};
+            const detail::snapshot_read_scope scope;
+            for (std::size_t ii = 0; ii < maxProbes; ++ii) {
+                auto& slot = slots[slotIndex(code, ii)];
+                const auto* entry = slot.load(std::memory_order_acquire);
+                if (entry == nullptr) {
+                    if (newEntry == nullptr) {
+                        newEntry = new name_entry{code, name};
+                    }
+                    if (slot.compare_exchange_strong(
+                            entry,
+                            newEntry,
+                            std::memory_order_acq_rel,
+                            std::memory_order_acquire)) {
+                        return true;
+                    }
+                    // entry now holds whatever claimed the slot first
+                }
+                if (entry->code == code) {
+                    break;
+                }
+            }
+            delete newEntry;
+            return false;
+        }
+        /// remove all the names
+        void clear()
+        {
+            auto removed = std::make_unique<retired_entries>();
+            for (auto& slot : slots) {
+                const auto* entry =
+                    slot.exchange(nullptr, std::memory_order_acq_rel);
+                if (entry != nullptr) {
+                    removed->emplace_back(entry);
+                }
+            }
+            if (!removed->empty()) {
+                // a reader may still be using an entry
+                detail::retireSnapshot(removed.release(), [](void* entries) {
+                    delete static_cast<retired_entries*>(entries);
+                });
+            }
+        }
+
+      private:
+        struct name_entry {
+            std::uint32_t code;
+            std::string name;
+        };
+        static constexpr std::size_t tableSize{4096U};
+        static constexpr std::size_t maxProbes{8U};
+        static constexpr std::size_t maxNameLength{128U};
+
+        static std::size_t slotIndex(std::uint32_t code, std::size_t probe)
+        {
+            return (code + probe) & (tableSize - 1U);
+        }
+        using retired_entries = std::vector<std::unique_ptr<const name_entry>>;
+        std::array<std::atomic<const name_entry*>, tableSize> slots{};
+    };
+}  // namespace
+
+// the current custom commodities, replaced as a whole when modified
+static std::atomic<const custom_commodities*> customCommodities{nullptr};
+// readers skip loading the custom commodities if there are none
+static std::atomic<bool> hasCustomCommodities{false};
+// serialize the modifications of the custom commodities
+static std::mutex customCommodityLock;
+// the names of commodities which were given generated codes
+static commodity_name_table generatedCommodityNames;
+
+static bool customCommoditiesInUse()
+{
+    return allowCustomCommodities.load(std::memory_order_acquire) &&
+        hasCustomCommodities.load(std::memory_order_acquire);
+}
+
+/// find the code of a custom commodity, returns false if there is none
+static bool findCustomCode(const std::string& comm, std::uint32_t& code)
+{
+    if (!customCommoditiesInUse()) {
+        return false;
+    }
+    const detail::snapshot_read_scope scope;
+    const auto* custom = customCommodities.load(std::memory_order_acquire);
+    if (custom == nullptr) {
+        return false;
+    }
+    auto fnd = custom->codes.find(comm);
+    if (fnd == custom->codes.end()) {
+        return false;
+    }
+    code = fnd->second;
+    return true;
+}
+
+/// find the name of a custom commodity, returns false if there is none
+static bool findCustomName(std::uint32_t code, std::string& name)
+{
+    if (!customCommoditiesInUse()) {
+        return false;
+    }
+    const detail::snapshot_read_scope scope;
+    const auto* custom = customCommodities.load(std::memory_order_acquire);
+    if (custom == nullptr) {
+        return false;
+    }
+    auto fnd = custom->names.find(code);
+    if (fnd == custom->names.end()) {
+        return false;
+    }
+    name = fnd->second;
+    return true;
+}
+
+/// publish a new set of custom commodities and retire the current one
+static void publishCustomCommodities(const custom_commodities* next)
+{
+    const auto* current =
+        customCommodities.exchange(next, std::memory_order_acq_rel);
+    detail::retireSnapshot(
+        const_cast<custom_commodities*>(current), [](void* custom) {
+            delete static_cast<custom_commodities*>(custom);
+        });
 }
-static commodities::commodityNameMap customCommodityCodes;
-static std::unordered_map<std::uint32_t, std::string> customCommodityNames;
+
 /// remove some escaped characters from a string mainly the escape character and
 /// (){}[]
 static void removeEscapeSequences(std::string& str)
@@ -241,17 +425,19 @@ static void removeEscapeSequences(std::string& str)
     }
 }
 // get the code to use for a particular commodity
-uint32_t getCommodity(std::string comm)
+uint32_t getCommodity(std::string comm, std::uint64_t match_flags)
 {
     removeEscapeSequences(comm);
     std::transform(comm.begin(), comm.end(), comm.begin(), ::tolower);
-    if (allowCustomCommodities.load(std::memory_order_acquire)) {
-        if (!customCommodityCodes.empty()) {
-            auto fnd2 = customCommodityCodes.find(comm);
-            if (fnd2 != customCommodityCodes.end()) {
-                return fnd2->second;
-            }
-        }
+    // a parse_context replaces the custom commodities
+    std::uint32_t contextCode{0};
+    const bool useContext = detail::contextCommodity(comm, contextCode);
+    if (contextCode != 0) {
+        return contextCode;
+    }
+    std::uint32_t customCode{0};
+    if (!useContext && findCustomCode(comm, customCode)) {
+        return customCode;
     }
 
     auto fnd = commodities::commodity_codes.find(comm);
@@ -281,20 +467,42 @@ uint32_t getCommodity(std::string comm)
     auto hcode = stringHash(comm);
     hcode &= 0x1FFFFFFFU;
     hcode |= 0x60000000U;
-    addCustomCommodity(comm, hcode);
+    // the hash code is what would be generated anyway so storing the name
+    // doesn't change the interpretation of any strings, parsing with a context
+    // doesn't modify anything global
+    if (!useContext && (match_flags & no_commodity_interning) == 0 &&
+        allowCustomCommodities.load(std::memory_order_acquire)) {
+        if (generatedCommodityNames.insert(hcode, comm)) {
+            // the name is now used when generating strings for the code
+            detail::invalidateUnitOutputCache();
+        }
+    }
 
     return hcode;
 }
 
+uint32_t getCommodity(std::string comm)
+{
+    return getCommodity(std::move(comm), getDefaultFlags());
+}
+
 // get the code to use for a particular commodity
 std::string getCommodityName(std::uint32_t commodity)
 {
+    std::string contextName;
+    const bool useContext =
+        detail::contextCommodityName(commodity, contextName);
+    if (!contextName.empty()) {
+        return contextName;
+    }
+    std::string customName;
+    if (!useContext && findCustomName(commodity, customName)) {
+        return customName;
+    }
     if (allowCustomCommodities.load(std::memory_order_acquire)) {
-        if (!customCommodityNames.empty()) {
-            auto fnd2 = customCommodityNames.find(commodity);
-            if (fnd2 != customCommodityNames.end()) {
-                return fnd2->second;
-            }
+        std::string name;
+        if (generatedCommodityNames.find(commodity, name)) {
+            return name;
         }
     }
     auto fnd = commodities::commodity_names.find(commodity);
@@ -320,16 +528,35 @@ std::string getCommodityName(std::uint32_t commodity)
 // add a custom commodity for later retrieval
 void addCustomCommodity(std::string comm, std::uint32_t code)
 {
-    if (allowCustomCommodities.load()) {
-        std::transform(comm.begin(), comm.end(), comm.begin(), ::tolower);
-        customCommodityNames.emplace(code, comm);
-        customCommodityCodes.emplace(comm, code);
+    if (!allowCustomCommodities.load(std::memory_order_acquire)) {
+        return;
     }
+    std::transform(comm.begin(), comm.end(), comm.begin(), ::tolower);
+    {
+        std::lock_guard<std::mutex> lock(customCommodityLock);
+        const auto* current =
+            customCommodities.load(std::memory_order_acquire);
+        auto next = (current != nullptr) ?
+            std::make_unique<custom_commodities>(*current) :
+            std::make_unique<custom_commodities>();
+        next->names.emplace(code, comm);
+        next->codes.emplace(std::move(comm), code);
+        publishCustomCommodities(next.release());
+        hasCustomCommodities.store(true, std::memory_order_release);
+    }
+    detail::invalidateStringParseCache();
+    detail::invalidateUnitOutputCache();
 }
 
 void clearCustomCommodities()
 {
-    customCommodityNames.clear();
-    customCommodityCodes.clear();
+    {
+        std::lock_guard<std::mutex> lock(customCommodityLock);
+        hasCustomCommodities.store(false, std::memory_order_release);
+        publishCustomCommodities(nullptr);
+    }
+    generatedCommodityNames.clear();
+    detail::invalidateStringParseCache();
+    detail::invalidateUnitOutputCache();
 }
 }  // namespace UNITS_NAMESPACE
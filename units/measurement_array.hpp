@@ -0,0 +1,438 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include "units.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/** @file defines a container of values sharing a single unit*/
+
+namespace UNITS_NAMESPACE {
+
+class measurement_array;
+
+/** a non-owning view of a contiguous array of values sharing a single unit
+@details the view is only valid while the underlying storage is alive and is
+not resized*/
+class measurement_array_view {
+  public:
+    /// Default constructor
+    // NOLINTNEXTLINE(modernize-use-equals-default)
+    constexpr measurement_array_view() noexcept {}
+    /// construct from a pointer to values and a unit
+    constexpr measurement_array_view(
+        const double* values,
+        std::size_t size,
+        const precise_unit& units) noexcept :
+        values_(values), size_(size), units_(units)
+    {
+    }
+    /// construct a view of an entire array
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    measurement_array_view(const measurement_array& array) noexcept;
+
+    constexpr std::size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr const double* data() const { return values_; }
+    constexpr const double* begin() const { return values_; }
+    constexpr const double* end() const { return values_ + size_; }
+    constexpr precise_unit units() const { return units_; }
+
+    /// get an element as a measurement
+    constexpr precise_measurement operator[](std::size_t index) const
+    {
+        return {values_[index], units_};
+    }
+    /// get an element as a measurement with bounds checking
+    precise_measurement at(std::size_t index) const
+    {
+        if (index >= size_) {
+            throw std::out_of_range("measurement_array index out of range");
+        }
+        return {values_[index], units_};
+    }
+    /// get a view of a portion of the array
+    measurement_array_view subview(std::size_t offset, std::size_t length)
+        const
+    {
+        if (offset > size_) {
+            offset = size_;
+        }
+        return {values_ + offset, (std::min)(length, size_ - offset), units_};
+    }
+
+    /// sum all the values
+    precise_measurement sum() const
+    {
+        double total{0.0};
+        for (std::size_t ii = 0; ii < size_; ++ii) {
+            total += values_[ii];
+        }
+        return {total, units_};
+    }
+    /// the arithmetic mean of the values
+    precise_measurement mean() const
+    {
+        if (size_ == 0) {
+            return {constants::invalid_conversion, units_};
+        }
+        return sum() / static_cast<double>(size_);
+    }
+    /// the smallest value
+    precise_measurement min() const
+    {
+        if (size_ == 0) {
+            return {constants::invalid_conversion, units_};
+        }
+        return {*std::min_element(begin(), end()), units_};
+    }
+    /// the largest value
+    precise_measurement max() const
+    {
+        if (size_ == 0) {
+            return {constants::invalid_conversion, units_};
+        }
+        return {*std::max_element(begin(), end()), units_};
+    }
+
+    /// Convert the values into a new array with different units
+    measurement_array convert_to(const precise_unit& newUnits) const;
+
+  private:
+    const double* values_{nullptr};
+    std::size_t size_{0};
+    precise_unit units_;
+};
+
+/** Class defining an array of values sharing a single unit
+@details the values are stored contiguously so operations apply the unit
+conversion once for the whole array instead of for each element.
+precise_measurement is the element type for interoperability.*/
+class measurement_array {
+  public:
+    /// Default constructor
+    measurement_array() = default;
+    /// construct an empty array with a unit
+    explicit measurement_array(const precise_unit& units) : units_(units) {}
+    /// construct an array of a given size with all the values the same
+    measurement_array(
+        std::size_t size,
+        double value,
+        const precise_unit& units) : values_(size, value), units_(units)
+    {
+    }
+    /// construct from a vector of values and a unit
+    measurement_array(std::vector<double> values, const precise_unit& units) :
+        values_(std::move(values)), units_(units)
+    {
+    }
+    /// construct from a set of measurements converted into a common unit
+    measurement_array(
+        const std::vector<precise_measurement>& measurements,
+        const precise_unit& units) : units_(units)
+    {
+        values_.reserve(measurements.size());
+        for (const auto& meas : measurements) {
+            values_.push_back(meas.value_as(units_));
+        }
+    }
+    /// construct an array with a copy of the values in a view
+    explicit measurement_array(const measurement_array_view& view) :
+        values_(view.begin(), view.end()), units_(view.units())
+    {
+    }
+
+    std::size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+    void reserve(std::size_t capacity) { values_.reserve(capacity); }
+    void clear() { values_.clear(); }
+    double* data() { return values_.data(); }
+    const double* data() const { return values_.data(); }
+    const std::vector<double>& values() const { return values_; }
+    precise_unit units() const { return units_; }
+
+    /// get an element as a measurement
+    precise_measurement operator[](std::size_t index) const
+    {
+        return {values_[index], units_};
+    }
+    /// get an element as a measurement with bounds checking
+    precise_measurement at(std::size_t index) const
+    {
+        return {values_.at(index), units_};
+    }
+    /// add a measurement to the end of the array, converting it if needed
+    void push_back(const precise_measurement& meas)
+    {
+        values_.push_back(meas.value_as(units_));
+    }
+    /// add a value to the end of the array
+    void push_back(double value) { values_.push_back(value); }
+
+    /// get a view of the entire array
+    measurement_array_view view() const
+    {
+        return {values_.data(), values_.size(), units_};
+    }
+    /// get a view of a portion of the array
+    measurement_array_view subview(std::size_t offset, std::size_t length)
+        const
+    {
+        return view().subview(offset, length);
+    }
+
+    precise_measurement sum() const { return view().sum(); }
+    precise_measurement mean() const { return view().mean(); }
+    precise_measurement min() const { return view().min(); }
+    precise_measurement max() const { return view().max(); }
+
+    /// Convert the values into a new array with different units
+    measurement_array convert_to(const precise_unit& newUnits) const
+    {
+        return view().convert_to(newUnits);
+    }
+    /// Convert the values in place to different units
+    void convert_in_place(const precise_unit& newUnits)
+    {
+        convert(values_.data(), values_.size(), units_, newUnits);
+        units_ = newUnits;
+    }
+
+    measurement_array& operator+=(const measurement_array_view& other);
+    measurement_array& operator-=(const measurement_array_view& other);
+    measurement_array& operator+=(const precise_measurement& other)
+    {
+        const double val = other.value_as(units_);
+        for (auto& value : values_) {
+            value += val;
+        }
+        return *this;
+    }
+    measurement_array& operator-=(const precise_measurement& other)
+    {
+        const double val = other.value_as(units_);
+        for (auto& value : values_) {
+            value -= val;
+        }
+        return *this;
+    }
+    measurement_array& operator*=(double val)
+    {
+        for (auto& value : values_) {
+            value *= val;
+        }
+        return *this;
+    }
+    measurement_array& operator/=(double val)
+    {
+        for (auto& value : values_) {
+            value /= val;
+        }
+        return *this;
+    }
+
+  private:
+    std::vector<double> values_;
+    precise_unit units_;
+};
+
+inline measurement_array_view::measurement_array_view(
+    const measurement_array& array) noexcept :
+    values_(array.data()), size_(array.size()), units_(array.units())
+{
+}
+
+inline measurement_array
+    measurement_array_view::convert_to(const precise_unit& newUnits) const
+{
+    std::vector<double> output(size_);
+    convert(values_, output.data(), size_, units_, newUnits);
+    return {std::move(output), newUnits};
+}
+
+namespace detail {
+    /// throw if two arrays used in an operation do not have the same size
+    inline void checkArraySizes(
+        const measurement_array_view& array1,
+        const measurement_array_view& array2)
+    {
+        if (array1.size() != array2.size()) {
+            throw std::invalid_argument(
+                "measurement_array operations require arrays of equal size");
+        }
+    }
+}  // namespace detail
+
+inline measurement_array&
+    measurement_array::operator+=(const measurement_array_view& other)
+{
+    detail::checkArraySizes(view(), other);
+    // convert the other values into this unit once for the whole array
+    converter conv(other.units(), units_);
+    if (conv.type() == converter::kind::linear) {
+        const double scale = conv.scale();
+        for (std::size_t ii = 0; ii < values_.size(); ++ii) {
+            values_[ii] += other.data()[ii] * scale;
+        }
+    } else {
+        std::vector<double> converted(other.size());
+        conv(other.data(), converted.data(), other.size());
+        for (std::size_t ii = 0; ii < values_.size(); ++ii) {
+            values_[ii] += converted[ii];
+        }
+    }
+    return *this;
+}
+
+inline measurement_array&
+    measurement_array::operator-=(const measurement_array_view& other)
+{
+    detail::checkArraySizes(view(), other);
+    converter conv(other.units(), units_);
+    if (conv.type() == converter::kind::linear) {
+        const double scale = conv.scale();
+        for (std::size_t ii = 0; ii < values_.size(); ++ii) {
+            values_[ii] -= other.data()[ii] * scale;
+        }
+    } else {
+        std::vector<double> converted(other.size());
+        conv(other.data(), converted.data(), other.size());
+        for (std::size_t ii = 0; ii < values_.size(); ++ii) {
+            values_[ii] -= converted[ii];
+        }
+    }
+    return *this;
+}
+
+/// add two arrays, the result is in the units of the first array
+inline measurement_array operator+(
+    const measurement_array_view& array1,
+    const measurement_array_view& array2)
+{
+    measurement_array result(array1);
+    result += array2;
+    return result;
+}
+/// subtract two arrays, the result is in the units of the first array
+inline measurement_array operator-(
+    const measurement_array_view& array1,
+    const measurement_array_view& array2)
+{
+    measurement_array result(array1);
+    result -= array2;
+    return result;
+}
+/// multiply two arrays element by element
+inline measurement_array operator*(
+    const measurement_array_view& array1,
+    const measurement_array_view& array2)
+{
+    detail::checkArraySizes(array1, array2);
+    std::vector<double> values(array1.size());
+    for (std::size_t ii = 0; ii < values.size(); ++ii) {
+        values[ii] = array1.data()[ii] * array2.data()[ii];
+    }
+    return {std::move(values), array1.units() * array2.units()};
+}
+/// divide two arrays element by element
+inline measurement_array operator/(
+    const measurement_array_view& array1,
+    const measurement_array_view& array2)
+{
+    detail::checkArraySizes(array1, array2);
+    std::vector<double> values(array1.size());
+    for (std::size_t ii = 0; ii < values.size(); ++ii) {
+        values[ii] = array1.data()[ii] / array2.data()[ii];
+    }
+    return {std::move(values), array1.units() / array2.units()};
+}
+
+/// add a measurement to every element of an array
+inline measurement_array operator+(
+    const measurement_array_view& array,
+    const precise_measurement& meas)
+{
+    measurement_array result(array);
+    result += meas;
+    return result;
+}
+/// subtract a measurement from every element of an array
+inline measurement_array operator-(
+    const measurement_array_view& array,
+    const precise_measurement& meas)
+{
+    measurement_array result(array);
+    result -= meas;
+    return result;
+}
+/// multiply every element of an array by a number
+inline measurement_array
+    operator*(const measurement_array_view& array, double val)
+{
+    measurement_array result(array);
+    result *= val;
+    return result;
+}
+/// multiply every element of an array by a number
+inline measurement_array
+    operator*(double val, const measurement_array_view& array)
+{
+    return array * val;
+}
+/// divide every element of an array by a number
+inline measurement_array
+    operator/(const measurement_array_view& array, double val)
+{
+    measurement_array result(array);
+    result /= val;
+    return result;
+}
+/// multiply every element of an array by a unit
+inline measurement_array
+    operator*(const measurement_array_view& array, const precise_unit& un)
+{
+    return {
+        std::vector<double>(array.begin(), array.end()), array.units() * un};
+}
+/// divide every element of an array by a unit
+inline measurement_array
+    operator/(const measurement_array_view& array, const precise_unit& un)
+{
+    return {
+        std::vector<double>(array.begin(), array.end()), array.units() / un};
+}
+/// multiply every element of an array by a measurement
+inline measurement_array operator*(
+    const measurement_array_view& array,
+    const precise_measurement& meas)
+{
+    std::vector<double> values(array.begin(), array.end());
+    const double val = meas.value();
+    for (auto& value : values) {
+        value *= val;
+    }
+    return {std::move(values), array.units() * meas.units()};
+}
+/// divide every element of an array by a measurement
+inline measurement_array operator/(
+    const measurement_array_view& array,
+    const precise_measurement& meas)
+{
+    std::vector<double> values(array.begin(), array.end());
+    const double val = meas.value();
+    for (auto& value : values) {
+        value /= val;
+    }
+    return {std::move(values), array.units() / meas.units()};
+}
+
+}  // namespace UNITS_NAMESPACE
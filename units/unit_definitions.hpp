@@ -1272,6 +1272,163 @@ namespace precise {
                     return val;
             }
         }
+
+        /// apply an operation to each value in an array
+        template<typename Operation>
+        inline void applyToValues(
+            const double* input,
+            double* output,
+            std::size_t size,
+            Operation op)
+        {
+            for (std::size_t ii = 0; ii < size; ++ii) {
+                output[ii] = op(input[ii]);
+            }
+        }
+
+#ifndef UNITS_HEADER_ONLY
+        /** compute 2^(scale*x) for each value in an array
+        @details the values are computed with a polynomial approximation which
+        vectorizes instead of a call to std::exp2 for each value.  The relative
+        error is below 2^-52*(4+|log2(result)|), which is under 3e-14 for
+        results between 1e-30 and 1e30.  The error grows with the magnitude of
+        the exponent since the rounding of scale*x is amplified by the
+        exponential. Results beyond the range of a double give 0 or inf and a
+        NaN input gives NaN*/
+        UNITS_EXPORT void exp2Values(
+            const double* input,
+            double* output,
+            std::size_t size,
+            double scale);
+        /** compute scale*log2(x) for each value in an array
+        @details the values are computed with a polynomial approximation which
+        vectorizes instead of a call to std::log2 for each value.  The relative
+        error is below 2^-50 (4 ulp). Values <= 0 or NaN give
+        invalid_conversion*/
+        UNITS_EXPORT void log2Values(
+            const double* input,
+            double* output,
+            std::size_t size,
+            double scale);
+
+        /** the scale to convert an equation value with exp2Values
+        @return 0 if the equation type is not an exponential of the value*/
+        inline double exp2ValueScale(const detail::unit_data& UT)
+        {
+            // log2(10) and log2(e)
+            constexpr double log2ten{3.321928094887362};
+            constexpr double log2e{1.4426950408889634};
+            const bool power = is_power_unit(UT);
+            switch (custom::eq_type(UT)) {
+                case 0:
+                case 10:
+                    return log2ten;
+                case 1:
+                    return power ? 2.0 * log2e : log2e;
+                case 2:
+                    return power ? log2ten : log2ten / 2.0;
+                case 3:
+                    return power ? log2ten / 10.0 : log2ten / 20.0;
+                case 9:
+                    return log2e;
+                case 11:
+                    return log2ten / 10.0;
+                case 13:
+                    return log2ten / 20.0;
+                default:
+                    return 0.0;
+            }
+        }
+
+        /** the scale to convert a value to an equation value with log2Values
+        @return 0 if the equation type is not a logarithm of the value*/
+        inline double log2ValueScale(const detail::unit_data& UT)
+        {
+            // log10(2) and ln(2)
+            constexpr double log10two{0.30102999566398120};
+            constexpr double lntwo{0.6931471805599453};
+            const bool power = is_power_unit(UT);
+            switch (custom::eq_type(UT)) {
+                case 0:
+                case 10:
+                    return log10two;
+                case 1:
+                    return power ? 0.5 * lntwo : lntwo;
+                case 2:
+                    return power ? log10two : 2.0 * log10two;
+                case 3:
+                    return power ? 10.0 * log10two : 20.0 * log10two;
+                case 9:
+                    return lntwo;
+                case 11:
+                    return 10.0 * log10two;
+                case 13:
+                    return 20.0 * log10two;
+                default:
+                    return 0.0;
+            }
+        }
+#endif
+
+        /** convert an array of equation unit values to values
+        @details the equation type is resolved once for the array.  The
+        logarithmic types use exp2Values so the results agree with
+        convert_equnit_to_value to within the error bound of exp2Values, the
+        other types and header only builds call convert_equnit_to_value for
+        each element*/
+        inline void convert_equnit_to_values(
+            const double* input,
+            double* output,
+            std::size_t size,
+            const detail::unit_data& UT)
+        {
+            if (!UT.is_equation()) {
+                if (input != output) {
+                    std::copy(input, input + size, output);
+                }
+                return;
+            }
+#ifndef UNITS_HEADER_ONLY
+            const double scale = exp2ValueScale(UT);
+            if (scale != 0.0) {
+                exp2Values(input, output, size, scale);
+                return;
+            }
+#endif
+            applyToValues(input, output, size, [&UT](double val) {
+                return convert_equnit_to_value(val, UT);
+            });
+        }
+
+        /** convert an array of values to equation unit values
+        @details the equation type is resolved once for the array.  The
+        logarithmic types use log2Values so the results agree with
+        convert_value_to_equnit to within the error bound of log2Values, the
+        other types and header only builds call convert_value_to_equnit for
+        each element*/
+        inline void convert_values_to_equnit(
+            const double* input,
+            double* output,
+            std::size_t size,
+            const detail::unit_data& UT)
+        {
+            if (!UT.is_equation()) {
+                if (input != output) {
+                    std::copy(input, input + size, output);
+                }
+                return;
+            }
+#ifndef UNITS_HEADER_ONLY
+            const double scale = log2ValueScale(UT);
+            if (scale != 0.0) {
+                log2Values(input, output, size, scale);
+                return;
+            }
+#endif
+            applyToValues(input, output, size, [&UT](double val) {
+                return convert_value_to_equnit(val, UT);
+            });
+        }
     }  // namespace equations
 
     /// Units used in the textile industry
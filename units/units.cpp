@@ -11,13 +11,20 @@ SPDX-License-Identifier: BSD-3-Clause
 #include <array>
 #include <atomic>
 #include <cctype>
+#include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -129,6 +136,195 @@ fixed_precise_measurement root(const fixed_precise_measurement& fpm, int power)
     return {numericalRoot(fpm.value(), power), root(fpm.units(), power)};
 }
 
+// the batch conversion kernels are cloned for several instruction sets and
+// the best one for the processor is selected when the library is loaded
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) &&         \
+    defined(__linux__)
+#define UNITS_BATCH_TARGETS                                                    \
+    __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define UNITS_BATCH_TARGETS
+#endif
+
+namespace detail {
+    UNITS_BATCH_TARGETS void convertLinearValues(
+        const double* input,
+        double* output,
+        std::size_t size,
+        double scale)
+    {
+        scaleValues(input, output, size, scale);
+    }
+
+    UNITS_BATCH_TARGETS void convertAffineValues(
+        const double* input,
+        double* output,
+        std::size_t size,
+        double scale,
+        double offset)
+    {
+        scaleOffsetValues(input, output, size, scale, offset);
+    }
+
+    UNITS_BATCH_TARGETS void convertInverseValues(
+        const double* input,
+        double* output,
+        std::size_t size,
+        double scale)
+    {
+        invertValues(input, output, size, scale);
+    }
+}  // namespace detail
+
+namespace {
+    inline std::uint64_t doubleBits(double val)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        return bits;
+    }
+    inline double bitsDouble(std::uint64_t bits)
+    {
+        double val;
+        std::memcpy(&val, &bits, sizeof(val));
+        return val;
+    }
+    // adding and subtracting 1.5*2^52 rounds a value to the nearest integer,
+    // the integer is left in the low bits of the sum
+    constexpr double roundingShift{6755399441055744.0};
+}  // namespace
+
+namespace precise {
+    namespace equations {
+        // the work is split into short loops over blocks held in local
+        // buffers, none of the loops has a branch containing a floating
+        // point operation, which would keep the compiler from vectorizing
+        // them without fast-math
+        constexpr std::size_t equationBlockSize{256};
+
+        UNITS_BATCH_TARGETS void exp2Values(
+            const double* input,
+            double* output,
+            std::size_t size,
+            double scale)
+        {
+            constexpr double ln2{0.6931471805599453};
+            const std::uint64_t shiftBits = doubleBits(roundingShift);
+            double exponents[equationBlockSize];
+            for (std::size_t start = 0; start < size;
+                 start += equationBlockSize) {
+                const std::size_t count = (std::min)(
+                    size - start, equationBlockSize);
+                // results outside this range overflow or underflow anyway
+                for (std::size_t ii = 0; ii < count; ++ii) {
+                    const double exponent = input[start + ii] * scale;
+                    exponents[ii] = (exponent > 1100.0) ?
+                        1100.0 :
+                        ((exponent < -1100.0) ? -1100.0 : exponent);
+                }
+                for (std::size_t ii = 0; ii < count; ++ii) {
+                    const double exponent = exponents[ii];
+                    const double shifted = exponent + roundingShift;
+                    const double whole = shifted - roundingShift;
+                    // exp(r) with |r|<=ln(2)/2, the terms through r^13/13!
+                    const double r = (exponent - whole) * ln2;
+                    double poly = 1.0 / 6227020800.0;
+                    poly = poly * r + 1.0 / 479001600.0;
+                    poly = poly * r + 1.0 / 39916800.0;
+                    poly = poly * r + 1.0 / 3628800.0;
+                    poly = poly * r + 1.0 / 362880.0;
+                    poly = poly * r + 1.0 / 40320.0;
+                    poly = poly * r + 1.0 / 5040.0;
+                    poly = poly * r + 1.0 / 720.0;
+                    poly = poly * r + 1.0 / 120.0;
+                    poly = poly * r + 1.0 / 24.0;
+                    poly = poly * r + 1.0 / 6.0;
+                    poly = poly * r + 0.5;
+                    poly = poly * r + 1.0;
+                    poly = poly * r + 1.0;
+                    // 2^whole is applied as two factors so results near the
+                    // ends of the exponent range are not lost
+                    const std::uint64_t half =
+                        doubleBits(whole * 0.5 + roundingShift) - shiftBits;
+                    const std::uint64_t rest =
+                        doubleBits(shifted) - shiftBits - half;
+                    output[start + ii] = poly *
+                        bitsDouble((half + 1023U) << 52U) *
+                        bitsDouble((rest + 1023U) << 52U);
+                }
+            }
+        }
+
+        UNITS_BATCH_TARGETS void log2Values(
+            const double* input,
+            double* output,
+            std::size_t size,
+            double scale)
+        {
+            constexpr double log2e{1.4426950408889634};
+            constexpr double twoTo54{18014398509481984.0};
+            constexpr double infinity{std::numeric_limits<double>::infinity()};
+            const std::uint64_t shiftBits = doubleBits(roundingShift);
+            const double infResult = scale * infinity;
+            double values[equationBlockSize];
+            double factors[equationBlockSize];
+            for (std::size_t start = 0; start < size;
+                 start += equationBlockSize) {
+                const std::size_t count = (std::min)(
+                    size - start, equationBlockSize);
+                // the factor moving subnormal values into the normal range
+                for (std::size_t ii = 0; ii < count; ++ii) {
+                    values[ii] = input[start + ii];
+                    factors[ii] =
+                        (values[ii] < (std::numeric_limits<double>::min)()) ?
+                        twoTo54 :
+                        1.0;
+                }
+                for (std::size_t ii = 0; ii < count; ++ii) {
+                    const std::uint64_t bits =
+                        doubleBits(values[ii] * factors[ii]);
+                    // val = mantissa*2^exponent with the mantissa in
+                    // [sqrt(2)/2,sqrt(2)), picked on the integer bits
+                    const std::uint64_t fraction =
+                        bits & 0x000FFFFFFFFFFFFFULL;
+                    const std::uint64_t high =
+                        (fraction > 0x0006A09E667F3BCDULL) ? 1U : 0U;
+                    const double mantissa =
+                        bitsDouble(fraction | ((1023U - high) << 52U));
+                    const double exponent =
+                        bitsDouble(shiftBits + (bits >> 52U) + high) -
+                        roundingShift -
+                        ((factors[ii] > 1.0) ? 1023.0 + 54.0 : 1023.0);
+                    // ln(m)=2*atanh(f) with f=(m-1)/(m+1), |f|<=0.172
+                    const double f = (mantissa - 1.0) / (mantissa + 1.0);
+                    const double f2 = f * f;
+                    double poly = 1.0 / 21.0;
+                    poly = poly * f2 + 1.0 / 19.0;
+                    poly = poly * f2 + 1.0 / 17.0;
+                    poly = poly * f2 + 1.0 / 15.0;
+                    poly = poly * f2 + 1.0 / 13.0;
+                    poly = poly * f2 + 1.0 / 11.0;
+                    poly = poly * f2 + 1.0 / 9.0;
+                    poly = poly * f2 + 1.0 / 7.0;
+                    poly = poly * f2 + 1.0 / 5.0;
+                    poly = poly * f2 + 1.0 / 3.0;
+                    poly = poly * f2 + 1.0;
+                    output[start + ii] =
+                        scale * (exponent + (2.0 * log2e) * f * poly);
+                }
+                // zero, negative, infinite and NaN values are patched last
+                for (std::size_t ii = 0; ii < count; ++ii) {
+                    const double val = values[ii];
+                    output[start + ii] = (val > 0.0 && val < infinity) ?
+                        output[start + ii] :
+                        ((val == infinity) ? infResult :
+                                             constants::invalid_conversion);
+                }
+            }
+        }
+    }  // namespace equations
+}  // namespace precise
+
 // sum the powers of a unit
 static int order(const unit& val)
 {
@@ -142,25 +338,172 @@ static int order(const unit& val)
 
 // NOTE no unit strings with '/' in it this can cause issues when converting to
 // string with out-of-order operations
-using umap = std::unordered_map<unit, const char*>;
+namespace {
+    /** index of the defined unit names keyed on the base unit bits
+    @details all the names sharing a set of base units are stored contiguously
+    and sorted by the rounded multiplier so a probe that misses on the base
+    units (the common case when generating strings) costs a single slot check.
+    The slots also record which base units have a named inverse so the string
+    generation can skip combinations without doing any unit arithmetic.
+    */
+    class unit_name_index {
+      public:
+        struct entry {
+            float multiplier;  // rounded multiplier used for matching
+            unit un;
+            const char* name;
+        };
+
+        template<typename ARRAY>
+        void addDefinitions(const ARRAY& definitions)
+        {
+            for (const auto& pr : definitions) {
+                if (pr.second != nullptr) {
+                    entries.push_back(
+                        entry{pr.first.cround(), pr.first, pr.second});
+                }
+            }
+        }
 
-static umap getDefinedBaseUnitNames()
-{
-    umap definedNames{};
-    for (const auto& name : defined_unit_names_si) {
-        if (name.second != nullptr) {
-            definedNames.emplace(name.first, name.second);
+        /// sort the entries and generate the lookup slots
+        void finalize()
+        {
+            // stable so the first definition of a unit takes precedence
+            std::stable_sort(
+                entries.begin(),
+                entries.end(),
+                [](const entry& e1, const entry& e2) {
+                    auto b1 = baseBits(e1.un.base_units());
+                    auto b2 = baseBits(e2.un.base_units());
+                    return (b1 < b2) ||
+                        (b1 == b2 && e1.multiplier < e2.multiplier);
+                });
+            entries.erase(
+                std::unique(
+                    entries.begin(),
+                    entries.end(),
+                    [](const entry& e1, const entry& e2) {
+                        return e1.un.base_units() == e2.un.base_units() &&
+                            e1.multiplier == e2.multiplier;
+                    }),
+                entries.end());
+            // each set of base units can take a slot for itself and one for
+            // its inverse
+            std::size_t slotCount{64U};
+            while (slotCount < entries.size() * 4) {
+                slotCount *= 2;
+            }
+            slots.assign(slotCount, slot_data{0U, 0U, 0U, 0U});
+            std::size_t first{0};
+            while (first < entries.size()) {
+                auto base = entries[first].un.base_units();
+                auto last = first + 1;
+                while (last < entries.size() &&
+                       entries[last].un.base_units() == base) {
+                    ++last;
+                }
+                auto& sdata = getSlot(baseBits(base));
+                sdata.first = static_cast<std::uint32_t>(first);
+                sdata.count = static_cast<std::uint32_t>(last - first);
+                sdata.state |= named_base;
+                getSlot(baseBits(base.inv())).state |= named_inverse;
+                first = last;
+            }
         }
-    }
-    for (const auto& name : defined_unit_names_customary) {
-        if (name.second != nullptr) {
-            definedNames.emplace(name.first, name.second);
+
+        /// find a unit in the index, returns nullptr if not found
+        const entry* find(const unit& un) const
+        {
+            const auto* sdata = findSlot(baseBits(un.base_units()));
+            if (sdata == nullptr || sdata->count == 0U) {
+                return nullptr;
+            }
+            auto mult = un.cround();
+            auto first = entries.begin() + sdata->first;
+            auto last = first + sdata->count;
+            auto fnd = std::lower_bound(
+                first, last, mult, [](const entry& ent, float val) {
+                    return ent.multiplier < val;
+                });
+            if (fnd != last && fnd->multiplier == mult) {
+                return &(*fnd);
+            }
+            return nullptr;
         }
-    }
+
+        /// check if any name is defined for a set of base units or its inverse
+        bool containsBaseOrInverse(const detail::unit_data& base) const
+        {
+            return findSlot(baseBits(base)) != nullptr;
+        }
+
+        const std::vector<entry>& values() const { return entries; }
+
+      private:
+        static constexpr std::uint32_t named_base{1U};
+        static constexpr std::uint32_t named_inverse{2U};
+
+        struct slot_data {
+            UNITS_BASE_TYPE bits;
+            std::uint32_t first;
+            std::uint32_t count;
+            std::uint32_t state;  // 0 for an empty slot
+        };
+
+        static UNITS_BASE_TYPE baseBits(const detail::unit_data& base)
+        {
+            UNITS_BASE_TYPE bits{0};
+            std::memcpy(&bits, &base, sizeof(bits));
+            return bits;
+        }
+        static std::size_t hashBits(UNITS_BASE_TYPE bits)
+        {
+            // Fibonacci hashing to spread the packed exponent bits
+            auto hash =
+                static_cast<std::uint64_t>(bits) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<std::size_t>(hash >> 32U);
+        }
+
+        const slot_data* findSlot(UNITS_BASE_TYPE bits) const
+        {
+            auto mask = slots.size() - 1;
+            for (auto slot = hashBits(bits) & mask;; slot = (slot + 1) & mask) {
+                const auto& sdata = slots[slot];
+                if (sdata.state == 0U) {
+                    return nullptr;
+                }
+                if (sdata.bits == bits) {
+                    return &sdata;
+                }
+            }
+        }
+
+        slot_data& getSlot(UNITS_BASE_TYPE bits)
+        {
+            auto mask = slots.size() - 1;
+            auto slot = hashBits(bits) & mask;
+            while (slots[slot].state != 0U && slots[slot].bits != bits) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot].bits = bits;
+            return slots[slot];
+        }
+
+        std::vector<entry> entries;
+        std::vector<slot_data> slots;
+    };
+}  // namespace
+
+static unit_name_index getDefinedBaseUnitNames()
+{
+    unit_name_index definedNames{};
+    definedNames.addDefinitions(defined_unit_names_si);
+    definedNames.addDefinitions(defined_unit_names_customary);
+    definedNames.finalize();
     return definedNames;
 }
 
-static const umap base_unit_names = getDefinedBaseUnitNames();
+static const unit_name_index base_unit_names = getDefinedBaseUnitNames();
 
 using ustr = std::pair<precise_unit, const char*>;
 // units to divide into tests to explore common multiplier units
@@ -274,10 +617,13 @@ static precise_unit unit_from_string_internal(
     std::uint64_t match_flags);
 
 // forward declaration of the quick find function
-static precise_unit
-    unit_quick_match(std::string unit_string, std::uint64_t match_flags);
+static precise_unit unit_quick_match(
+    const std::string& unit_string,
+    std::uint64_t match_flags);
 // forward declaration of the function to check for custom units
-static precise_unit checkForCustomUnit(const std::string& unit_string);
+static precise_unit checkForCustomUnit(
+    const std::string& unit_string,
+    std::uint64_t match_flags);
 
 // check if the character is an ascii digit
 static inline bool isDigitCharacter(char X)
@@ -670,13 +1016,169 @@ static std::string
 
 static std::atomic<bool> allowUserDefinedUnits{true};
 
+// generation counter for the interpretation of strings, anything that changes
+// how a string would be interpreted increments this
+static std::atomic<std::uint64_t> stringParseGeneration{0U};
+// generation counter for the strings produced from units, anything that
+// changes the string generated for a unit increments this
+static std::atomic<std::uint64_t> unitOutputGeneration{0U};
+
+namespace detail {
+    void invalidateStringParseCache()
+    {
+        stringParseGeneration.fetch_add(1U, std::memory_order_acq_rel);
+    }
+    void invalidateUnitOutputCache()
+    {
+        unitOutputGeneration.fetch_add(1U, std::memory_order_acq_rel);
+    }
+}  // namespace detail
+
+namespace {
+    /** a thread safe least recently used cache split into a number of
+    independently locked shards to reduce contention
+    @details the Key type must have a public hash member containing a
+    precomputed hash of the key, entries stored under an older generation are
+    treated as missing*/
+    template<typename Key, typename Value>
+    class sharded_lru_cache {
+      public:
+        bool find(const Key& key, std::uint64_t generation, Value& value)
+        {
+            auto& shard = getShard(key);
+            std::lock_guard<std::mutex> lock(shard.lock);
+            auto fnd = shard.index.find(key);
+            if (fnd == shard.index.end()) {
+                ++shard.misses;
+                return false;
+            }
+            if (fnd->second.generation != generation) {
+                shard.order.erase(fnd->second.position);
+                shard.index.erase(fnd);
+                ++shard.misses;
+                return false;
+            }
+            shard.order.splice(
+                shard.order.begin(), shard.order, fnd->second.position);
+            value = fnd->second.value;
+            ++shard.hits;
+            return true;
+        }
+
+        void insert(Key key, std::uint64_t generation, const Value& value)
+        {
+            auto& shard = getShard(key);
+            std::lock_guard<std::mutex> lock(shard.lock);
+            if (shard.capacity == 0) {
+                return;
+            }
+            auto res = shard.index.emplace(
+                std::move(key),
+                node{value, generation, shard.order.end()});
+            if (!res.second) {
+                res.first->second.value = value;
+                res.first->second.generation = generation;
+                shard.order.splice(
+                    shard.order.begin(),
+                    shard.order,
+                    res.first->second.position);
+                return;
+            }
+            shard.order.push_front(&(res.first->first));
+            res.first->second.position = shard.order.begin();
+            evict(shard);
+        }
+
+        void setCapacity(std::size_t capacity)
+        {
+            auto shardCapacity =
+                (capacity == 0) ? 0 : (capacity + shardCount - 1) / shardCount;
+            for (auto& shard : shards) {
+                std::lock_guard<std::mutex> lock(shard.lock);
+                shard.capacity = shardCapacity;
+                evict(shard);
+            }
+        }
+
+        void clear()
+        {
+            for (auto& shard : shards) {
+                std::lock_guard<std::mutex> lock(shard.lock);
+                shard.order.clear();
+                shard.index.clear();
+                shard.hits = 0;
+                shard.misses = 0;
+            }
+        }
+
+        cache_statistics statistics()
+        {
+            cache_statistics stats;
+            for (auto& shard : shards) {
+                std::lock_guard<std::mutex> lock(shard.lock);
+                stats.hits += shard.hits;
+                stats.misses += shard.misses;
+                stats.size += shard.index.size();
+                stats.capacity += shard.capacity;
+            }
+            return stats;
+        }
+
+      private:
+        static constexpr std::size_t shardCount{16U};
+
+        struct node {
+            Value value;
+            std::uint64_t generation;
+            typename std::list<const Key*>::iterator position;
+        };
+        struct keyHash {
+            std::size_t operator()(const Key& key) const noexcept
+            {
+                return key.hash;
+            }
+        };
+        struct shard_data {
+            std::mutex lock;
+            std::list<const Key*> order;
+            std::unordered_map<Key, node, keyHash> index;
+            std::size_t capacity{0};
+            std::uint64_t hits{0};
+            std::uint64_t misses{0};
+        };
+
+        shard_data& getShard(const Key& key)
+        {
+            // the low bits are used by the unordered_map buckets
+            return shards[(key.hash >> 16U) % shardCount];
+        }
+
+        static void evict(shard_data& shard)
+        {
+            while (shard.index.size() > shard.capacity &&
+                   !shard.order.empty()) {
+                auto fnd = shard.index.find(*shard.order.back());
+                shard.order.pop_back();
+                if (fnd != shard.index.end()) {
+                    shard.index.erase(fnd);
+                }
+            }
+        }
+        std::array<shard_data, shardCount> shards;
+    };
+}  // namespace
+
 void disableUserDefinedUnits()
 {
     allowUserDefinedUnits.store(false);
+    detail::invalidateStringParseCache();
+    detail::invalidateUnitOutputCache();
 }
 void enableUserDefinedUnits()
 {
     allowUserDefinedUnits.store(true);
+    detail::invalidateStringParseCache();
+    detail::invalidateUnitOutputCache();
 }
 
 static constexpr int getDefaultDomain()
@@ -689,11 +1191,12 @@ static constexpr int getDefaultDomain()
 }
 
 // how different unit strings can be specified to mean different things
-static std::uint64_t unitsDomain{getDefaultDomain()};
+static std::atomic<std::uint64_t> unitsDomain{getDefaultDomain()};
 
 std::uint64_t setUnitsDomain(std::uint64_t newDomain)
 {
-    std::swap(newDomain, unitsDomain);
+    newDomain = unitsDomain.exchange(newDomain, std::memory_order_acq_rel);
+    detail::invalidateStringParseCache();
     return newDomain;
 }
 
@@ -706,17 +1209,19 @@ static constexpr std::uint64_t getDefaultMatchFlags()
 #endif
 }
 
-static std::uint64_t defaultMatchFlags{getDefaultMatchFlags()};
+static std::atomic<std::uint64_t> defaultMatchFlags{getDefaultMatchFlags()};
 
 std::uint64_t setDefaultFlags(std::uint64_t defaultFlags)
 {
-    std::swap(defaultMatchFlags, defaultFlags);
+    defaultFlags =
+        defaultMatchFlags.exchange(defaultFlags, std::memory_order_acq_rel);
+    detail::invalidateStringParseCache();
     return defaultFlags;
 }
 
 std::uint64_t getDefaultFlags()
 {
-    return defaultMatchFlags;
+    return defaultMatchFlags.load(std::memory_order_acquire);
 }
 
 using smap = std::unordered_map<std::string, precise_unit>;
@@ -725,14 +1230,313 @@ using smap = std::unordered_map<std::string, precise_unit>;
 static double
     getDoubleFromString(const std::string& ustring, size_t* index) noexcept;
 
-static std::unordered_map<unit, std::string> user_defined_unit_names;
-static smap user_defined_units;
+/* Shared tables such as the user defined units are published as immutable
+snapshots through an atomic pointer.  Readers announce the epoch they started
+in, a replaced snapshot is only freed once every reader which could have seen
+it has finished.  Reading never locks or touches memory written by other
+readers, writers take a mutex to retire the old snapshot.*/
+namespace {
+    /// the epoch announcement of a thread
+    struct snapshot_reader_slot {
+        // the epoch the current read started in, 0 if the thread isn't reading
+        std::atomic<std::uint64_t> epoch{0};
+        std::atomic<bool> inUse{true};
+        snapshot_reader_slot* next{nullptr};
+        // keep the announcements of different threads on separate cache lines
+        char padding[64]{};
+    };
+
+    /// a snapshot waiting until no reader can still be using it
+    struct retired_snapshot {
+        void* object;
+        void (*destroy)(void*);
+        std::uint64_t epoch;
+    };
+}  // namespace
+
+static std::atomic<std::uint64_t> snapshotEpoch{1};
+// the slots are reused by later threads and never freed
+static std::atomic<snapshot_reader_slot*> snapshotReaders{nullptr};
+static std::mutex retiredSnapshotLock;
+static std::vector<retired_snapshot> retiredSnapshots;
+
+namespace {
+    /// the slot of the current thread, released when the thread exits
+    class snapshot_reader {
+      public:
+        snapshot_reader()
+        {
+            for (auto* reader = snapshotReaders.load(std::memory_order_acquire);
+                 reader != nullptr;
+                 reader = reader->next) {
+                bool used{false};
+                if (reader->inUse.compare_exchange_strong(
+                        used, true, std::memory_order_acq_rel)) {
+                    slot = reader;
+                    return;
+                }
+            }
+            slot = new snapshot_reader_slot;
+            slot->next = snapshotReaders.load(std::memory_order_relaxed);
+            while (!snapshotReaders.compare_exchange_weak(
+                slot->next, slot, std::memory_order_acq_rel)) {
+            }
+        }
+        ~snapshot_reader()
+        {
+            slot->inUse.store(false, std::memory_order_release);
+        }
+        snapshot_reader(const snapshot_reader&) = delete;
+        snapshot_reader& operator=(const snapshot_reader&) = delete;
+
+        snapshot_reader_slot* slot{nullptr};
+        int depth{0};
+    };
+}  // namespace
+
+static snapshot_reader& currentSnapshotReader()
+{
+    static thread_local snapshot_reader reader;
+    return reader;
+}
+
+namespace detail {
+    void beginSnapshotRead() noexcept
+    {
+        auto& reader = currentSnapshotReader();
+        if (reader.depth++ == 0) {
+            reader.slot->epoch.store(
+                snapshotEpoch.load(std::memory_order_acquire),
+                std::memory_order_relaxed);
+            // order the announcement before any load of a snapshot pointer
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+    void endSnapshotRead() noexcept
+    {
+        auto& reader = currentSnapshotReader();
+        if (--reader.depth == 0) {
+            reader.slot->epoch.store(0, std::memory_order_release);
+        }
+    }
+    void retireSnapshot(void* object, void (*destroy)(void*))
+    {
+        if (object == nullptr) {
+            return;
+        }
+        std::vector<retired_snapshot> freed;
+        {
+            std::lock_guard<std::mutex> lock(retiredSnapshotLock);
+            // readers announcing a later epoch see the replacement
+            retiredSnapshots.push_back(
+                {object,
+                 destroy,
+                 snapshotEpoch.fetch_add(1, std::memory_order_acq_rel)});
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto oldest = (std::numeric_limits<std::uint64_t>::max)();
+            for (auto* reader = snapshotReaders.load(std::memory_order_acquire);
+                 reader != nullptr;
+                 reader = reader->next) {
+                auto epoch = reader->epoch.load(std::memory_order_acquire);
+                if (epoch != 0 && epoch < oldest) {
+                    oldest = epoch;
+                }
+            }
+            auto keep = std::partition(
+                retiredSnapshots.begin(),
+                retiredSnapshots.end(),
+                [oldest](const retired_snapshot& retired) {
+                    return retired.epoch >= oldest;
+                });
+            freed.assign(keep, retiredSnapshots.end());
+            retiredSnapshots.erase(keep, retiredSnapshots.end());
+        }
+        for (auto& retired : freed) {
+            retired.destroy(retired.object);
+        }
+    }
+}  // namespace detail
+
+namespace {
+    /** the user defined units, a registry is never modified once it is
+    published so any number of threads can read it while a modified copy is
+    being built*/
+    struct user_defined_registry {
+        smap units;
+        std::unordered_map<unit, std::string> names;
+    };
+}  // namespace
+
+// the current registry, this is null if there are no user defined units
+static std::atomic<const user_defined_registry*> userDefinedRegistry{nullptr};
+// readers skip loading the registry if there are no user defined units
+static std::atomic<bool> hasUserDefinedUnits{false};
+// serialize the writers so no modification is lost
+static std::mutex userDefinedWriteLock;
+
+namespace {
+    /** a registry in use by a reader, the registry is not freed while the
+    snapshot is held even if it is replaced*/
+    class registry_snapshot {
+      public:
+        registry_snapshot() = default;
+        /// a registry which is not shared with writers
+        explicit registry_snapshot(const user_defined_registry* registry) :
+            registry_(registry)
+        {
+        }
+        /// a registry loaded from a shared pointer, reading starts first
+        explicit registry_snapshot(
+            const std::atomic<const user_defined_registry*>& shared) :
+            scope_(true), registry_(shared.load(std::memory_order_acquire))
+        {
+        }
+
+        explicit operator bool() const { return registry_ != nullptr; }
+        const user_defined_registry* operator->() const { return registry_; }
+
+      private:
+        detail::snapshot_read_scope scope_{false};
+        const user_defined_registry* registry_{nullptr};
+    };
+}  // namespace
+
+namespace detail {
+    /// the units and commodities of a parse_context, these are never modified
+    /// once they are in use by a context
+    struct parse_context_tables {
+        user_defined_registry registry;
+        std::unordered_map<std::string, std::uint32_t> commodities;
+        std::unordered_map<std::uint32_t, std::string> commodityNames;
+    };
+
+    struct parse_context_access {
+        static const parse_context_tables* tables(const parse_context& context)
+        {
+            return context.tables_.get();
+        }
+        static parse_context_cache* cache(const parse_context& context)
+        {
+            return context.cache_.get();
+        }
+    };
+}  // namespace detail
+
+// the context in use by the current thread, null if the global settings apply
+static thread_local const parse_context* activeParseContext{nullptr};
+
+namespace {
+    /// scope guard making a context active on the current thread
+    class context_scope {
+      public:
+        explicit context_scope(const parse_context& context) :
+            previous(activeParseContext)
+        {
+            activeParseContext = &context;
+        }
+        ~context_scope() { activeParseContext = previous; }
+        context_scope(const context_scope&) = delete;
+        context_scope& operator=(const context_scope&) = delete;
+
+      private:
+        const parse_context* previous;
+    };
+}  // namespace
+
+namespace detail {
+    /** find a commodity in the active context
+    @return true if a context is active in which case the global custom
+    commodities are not used, code is left unchanged if the context does not
+    contain the commodity*/
+    bool contextCommodity(const std::string& comm, std::uint32_t& code)
+    {
+        if (activeParseContext == nullptr) {
+            return false;
+        }
+        const auto* tables =
+            detail::parse_context_access::tables(*activeParseContext);
+        if (tables != nullptr) {
+            auto fnd = tables->commodities.find(comm);
+            if (fnd != tables->commodities.end()) {
+                code = fnd->second;
+            }
+        }
+        return true;
+    }
+    /** find the name of a commodity in the active context
+    @return true if a context is active, name is left unchanged if the context
+    does not contain the commodity*/
+    bool contextCommodityName(std::uint32_t code, std::string& name)
+    {
+        if (activeParseContext == nullptr) {
+            return false;
+        }
+        const auto* tables =
+            detail::parse_context_access::tables(*activeParseContext);
+        if (tables != nullptr) {
+            auto fnd = tables->commodityNames.find(code);
+            if (fnd != tables->commodityNames.end()) {
+                name = fnd->second;
+            }
+        }
+        return true;
+    }
+}  // namespace detail
+
+/** get the current user defined unit registry, the registry remains valid for
+as long as the snapshot is held even if it is replaced*/
+static registry_snapshot userDefinedUnits()
+{
+    if (activeParseContext != nullptr) {
+        const auto* tables =
+            detail::parse_context_access::tables(*activeParseContext);
+        if (tables == nullptr ||
+            (tables->registry.units.empty() &&
+             tables->registry.names.empty())) {
+            return registry_snapshot{};
+        }
+        // the context outlives the parse and is never modified
+        return registry_snapshot{&tables->registry};
+    }
+    if (!allowUserDefinedUnits.load(std::memory_order_acquire) ||
+        !hasUserDefinedUnits.load(std::memory_order_acquire)) {
+        return registry_snapshot{};
+    }
+    return registry_snapshot{userDefinedRegistry};
+}
+
+/** modify a copy of the user defined unit registry and publish it in place of
+the current one*/
+template<typename Modifier>
+static void modifyUserDefinedUnits(Modifier modify)
+{
+    std::lock_guard<std::mutex> lock(userDefinedWriteLock);
+    const auto* current = userDefinedRegistry.load(std::memory_order_acquire);
+    auto next = (current != nullptr) ?
+        std::make_unique<user_defined_registry>(*current) :
+        std::make_unique<user_defined_registry>();
+    modify(*next);
+    const bool empty = next->units.empty() && next->names.empty();
+    if (empty) {
+        next.reset();
+    }
+    userDefinedRegistry.store(next.release(), std::memory_order_release);
+    hasUserDefinedUnits.store(!empty, std::memory_order_release);
+    detail::retireSnapshot(
+        const_cast<user_defined_registry*>(current), [](void* registry) {
+            delete static_cast<user_defined_registry*>(registry);
+        });
+}
 
 void addUserDefinedUnit(const std::string& name, const precise_unit& un)
 {
     if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        user_defined_unit_names[unit_cast(un)] = name;
-        user_defined_units[name] = un;
+        modifyUserDefinedUnits([&](user_defined_registry& registry) {
+            registry.names[unit_cast(un)] = name;
+            registry.units[name] = un;
+        });
+        detail::invalidateStringParseCache();
+        detail::invalidateUnitOutputCache();
         allowUserDefinedUnits.store(
             allowUserDefinedUnits.load(std::memory_order_acquire),
             std::memory_order_release);
@@ -744,22 +1548,31 @@ void removeUserDefinedUnit(const std::string& name)
     // get the currently converted unit
     auto unit = unit_cast_from_string(name);
     if (is_valid(unit)) {
-        user_defined_units.erase(name);
-        user_defined_unit_names.erase(unit);
+        modifyUserDefinedUnits([&](user_defined_registry& registry) {
+            registry.units.erase(name);
+            registry.names.erase(unit);
+        });
+        detail::invalidateStringParseCache();
     } else {
-        for (const auto& udun : user_defined_unit_names) {
-            if (udun.second == name) {
-                user_defined_unit_names.erase(udun.first);
-                break;
+        modifyUserDefinedUnits([&](user_defined_registry& registry) {
+            for (const auto& udun : registry.names) {
+                if (udun.second == name) {
+                    registry.names.erase(udun.first);
+                    break;
+                }
             }
-        }
+        });
     }
+    detail::invalidateUnitOutputCache();
 }
 
 void addUserDefinedInputUnit(const std::string& name, const precise_unit& un)
 {
     if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        user_defined_units[name] = un;
+        modifyUserDefinedUnits([&](user_defined_registry& registry) {
+            registry.units[name] = un;
+        });
+        detail::invalidateStringParseCache();
         allowUserDefinedUnits.store(
             allowUserDefinedUnits.load(std::memory_order_acquire),
             std::memory_order_release);
@@ -769,7 +1582,10 @@ void addUserDefinedInputUnit(const std::string& name, const precise_unit& un)
 void addUserDefinedOutputUnit(const std::string& name, const precise_unit& un)
 {
     if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        user_defined_unit_names[unit_cast(un)] = name;
+        modifyUserDefinedUnits([&](user_defined_registry& registry) {
+            registry.names[unit_cast(un)] = name;
+        });
+        detail::invalidateUnitOutputCache();
         allowUserDefinedUnits.store(
             allowUserDefinedUnits.load(std::memory_order_acquire),
             std::memory_order_release);
@@ -886,8 +1702,12 @@ std::string definedUnitsFromFile(const std::string& filename) noexcept
 
 void clearUserDefinedUnits()
 {
-    user_defined_unit_names.clear();
-    user_defined_units.clear();
+    modifyUserDefinedUnits([](user_defined_registry& registry) {
+        registry.units.clear();
+        registry.names.clear();
+    });
+    detail::invalidateStringParseCache();
+    detail::invalidateUnitOutputCache();
 }
 
 // add escapes for some particular sequences
@@ -1100,7 +1920,7 @@ static std::string
             if (loc == std::string::npos) {
                 propUnitString += cString;
             } else if (propUnitString.compare(0, 2, "1/") == 0) {
-                auto rs = checkForCustomUnit(cString);
+                auto rs = checkForCustomUnit(cString, no_commodity_interning);
                 if (!is_error(rs)) {
                     cString.insert(0, 1, '1');
                 }
@@ -1111,7 +1931,8 @@ static std::string
                     propUnitString[locp + 1] != '-') {
                     propUnitString.insert(locp, cString);
                 } else {
-                    auto rs = checkForCustomUnit(cString);
+                    auto rs =
+                        checkForCustomUnit(cString, no_commodity_interning);
                     if (!is_error(rs)) {
                         // this condition would take a very particular and odd
                         // string to trigger I haven't figured out a test case
@@ -1127,7 +1948,7 @@ static std::string
         } else {  // inverse commodity
             auto loc = propUnitString.find_last_of('/');
             if (loc == std::string::npos) {
-                auto rs = checkForCustomUnit(cString);
+                auto rs = checkForCustomUnit(cString, no_commodity_interning);
                 if (!is_error(rs)) {  // this check is needed because it is
                                       // possible to define a commodity that
                                       // would look like a form
@@ -1159,38 +1980,54 @@ static const std::pair<const unit, std::string> nullret{invalid, std::string{}};
 
 static std::pair<unit, std::string> find_unit_pair(unit un)
 {  // cppcheck suppression active
-    if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        if (!user_defined_unit_names.empty()) {
-            auto fndud = user_defined_unit_names.find(un);
-            if (fndud != user_defined_unit_names.end()) {
+    auto registry = userDefinedUnits();
+    if (registry) {
+        if (!registry->names.empty()) {
+            auto fndud = registry->names.find(un);
+            if (fndud != registry->names.end()) {
                 return {fndud->first, fndud->second};
             }
         }
     }
-    auto fnd = base_unit_names.find(un);
-    if (fnd != base_unit_names.end()) {
-        return {fnd->first, fnd->second};
+    const auto* fnd = base_unit_names.find(un);
+    if (fnd != nullptr) {
+        return {fnd->un, fnd->name};
     }
     return nullret;
 }
 
 static std::string find_unit(unit un)
 {  // cppcheck suppression active
-    if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        if (!user_defined_unit_names.empty()) {
-            auto fndud = user_defined_unit_names.find(un);
-            if (fndud != user_defined_unit_names.end()) {
+    auto registry = userDefinedUnits();
+    if (registry) {
+        if (!registry->names.empty()) {
+            auto fndud = registry->names.find(un);
+            if (fndud != registry->names.end()) {
                 return fndud->second;
             }
         }
     }
-    auto fnd = base_unit_names.find(un);
-    if (fnd != base_unit_names.end()) {
-        return fnd->second;
+    const auto* fnd = base_unit_names.find(un);
+    if (fnd != nullptr) {
+        return fnd->name;
     }
     return std::string{};
 }
 
+// check whether any of the unit combinations tried by probeUnit and
+// probeUnitBase could be found, independent of the multiplier
+static bool hasProbeCandidate(const precise_unit& un, const precise_unit& probe)
+{
+    auto registry = userDefinedUnits();
+    if (registry && !registry->names.empty()) {
+        return true;
+    }
+    auto mbase = un.base_units() * probe.base_units();
+    auto dbase = un.base_units() / probe.base_units();
+    return base_unit_names.containsBaseOrInverse(mbase) ||
+        base_unit_names.containsBaseOrInverse(dbase);
+}
+
 static std::string probeUnit(
     const precise_unit& un,
     const std::pair<precise_unit, const char*>& probe)
@@ -1584,6 +2421,9 @@ static std::string
     std::string beststr;
 
     for (const auto& tu : testUnits) {
+        if (!hasProbeCandidate(un, tu.first)) {
+            continue;
+        }
         auto str = probeUnit(un, tu);
         if (!str.empty()) {
             return str;
@@ -1599,8 +2439,9 @@ static std::string
         }
     }
 
-    if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        for (const auto& udu : user_defined_unit_names) {
+    auto registry = userDefinedUnits();
+    if (registry) {
+        for (const auto& udu : registry->names) {
             auto res = probeUnit(
                 un,
                 std::make_pair(precise_unit(udu.first), udu.second.c_str()));
@@ -1628,22 +2469,26 @@ static std::string
 
     // let's try common units that are often multiplied by power
     for (const auto& tu : testPowerUnits) {
-        std::string nstring = std::string(tu.second) + "^2";
-        auto res = probeUnit(
-            un, std::make_pair(precise_unit(tu.first).pow(2), nstring.c_str()));
-        if (!res.empty()) {
-            return res;
+        auto punit = precise_unit(tu.first).pow(2);
+        if (hasProbeCandidate(un, punit)) {
+            std::string nstring = std::string(tu.second) + "^2";
+            auto res = probeUnit(un, std::make_pair(punit, nstring.c_str()));
+            if (!res.empty()) {
+                return res;
+            }
         }
-        nstring = std::string(tu.second) + "^3";
-        res = probeUnit(
-            un, std::make_pair(precise_unit(tu.first).pow(3), nstring.c_str()));
-        if (!res.empty()) {
-            return res;
+        punit = precise_unit(tu.first).pow(3);
+        if (hasProbeCandidate(un, punit)) {
+            std::string nstring = std::string(tu.second) + "^3";
+            auto res = probeUnit(un, std::make_pair(punit, nstring.c_str()));
+            if (!res.empty()) {
+                return res;
+            }
         }
     }
 
-    if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        for (const auto& udu : user_defined_unit_names) {
+    if (registry) {
+        for (const auto& udu : registry->names) {
             auto str = probeUnitBase(
                 un,
                 std::make_pair(precise_unit(udu.first), udu.second.c_str()));
@@ -1685,27 +2530,32 @@ static std::string
         }
     }
     for (const auto& tu : testPowerUnits) {
-        std::string nstring = std::string(tu.second) + "^2";
-        auto str = probeUnitBase(
-            un, std::make_pair(precise_unit(tu.first).pow(2), nstring.c_str()));
-        if (!str.empty()) {
-            if (!isNumericalStartCharacter(str.front())) {
-                return str;
-            }
-            if (beststr.empty() || str.size() < beststr.size()) {
-                beststr = str;
+        auto punit = precise_unit(tu.first).pow(2);
+        if (hasProbeCandidate(un, punit)) {
+            std::string nstring = std::string(tu.second) + "^2";
+            auto str =
+                probeUnitBase(un, std::make_pair(punit, nstring.c_str()));
+            if (!str.empty()) {
+                if (!isNumericalStartCharacter(str.front())) {
+                    return str;
+                }
+                if (beststr.empty() || str.size() < beststr.size()) {
+                    beststr = str;
+                }
             }
         }
-
-        nstring = std::string(tu.second) + "^3";
-        str = probeUnitBase(
-            un, std::make_pair(precise_unit(tu.first).pow(3), nstring.c_str()));
-        if (!str.empty()) {
-            if (!isNumericalStartCharacter(str.front())) {
-                return str;
-            }
-            if (beststr.empty() || str.size() < beststr.size()) {
-                beststr = str;
+        punit = precise_unit(tu.first).pow(3);
+        if (hasProbeCandidate(un, punit)) {
+            std::string nstring = std::string(tu.second) + "^3";
+            auto str =
+                probeUnitBase(un, std::make_pair(punit, nstring.c_str()));
+            if (!str.empty()) {
+                if (!isNumericalStartCharacter(str.front())) {
+                    return str;
+                }
+                if (beststr.empty() || str.size() < beststr.size()) {
+                    beststr = str;
+                }
             }
         }
     }
@@ -1732,10 +2582,79 @@ static std::string
         min_mult + generateRawUnitString(mino_unit, match_flags));
 }
 
+namespace {
+    /// key for caching the strings generated from units
+    struct unit_output_key {
+        unit_output_key(const precise_unit& un, std::uint64_t flags) :
+            base(un.base_units()), commodity(un.commodity()),
+            match_flags(flags)
+        {
+            // the exact bits are used so -0.0 and nan are handled consistently
+            auto mult = un.multiplier();
+            std::memcpy(&multiplier, &mult, sizeof(multiplier));
+            hash = std::hash<std::uint64_t>{}(multiplier) ^
+                std::hash<detail::unit_data>{}(base) ^
+                std::hash<std::uint64_t>{}(
+                       match_flags ^
+                       (static_cast<std::uint64_t>(commodity) << 32U));
+        }
+        std::uint64_t multiplier{0};
+        detail::unit_data base;
+        std::uint32_t commodity;
+        std::uint64_t match_flags;
+        std::size_t hash{0};
+        bool operator==(const unit_output_key& other) const
+        {
+            return multiplier == other.multiplier && base == other.base &&
+                commodity == other.commodity &&
+                match_flags == other.match_flags;
+        }
+    };
+}  // namespace
+
+static sharded_lru_cache<unit_output_key, std::string> unitOutputCache;
+static std::atomic<bool> useUnitOutputCache{false};
+
+void enableUnitOutputCache(std::size_t capacity)
+{
+    unitOutputCache.setCapacity(capacity);
+    useUnitOutputCache.store(capacity > 0, std::memory_order_release);
+}
+
+void disableUnitOutputCache()
+{
+    useUnitOutputCache.store(false, std::memory_order_release);
+    unitOutputCache.setCapacity(0);
+}
+
+void clearUnitOutputCache()
+{
+    unitOutputCache.clear();
+}
+
+cache_statistics getUnitOutputCacheStatistics()
+{
+    return unitOutputCache.statistics();
+}
+
 std::string to_string(const precise_unit& un, std::uint64_t match_flags)
 {
-    return clean_unit_string(
-        to_string_internal(un, match_flags), un.commodity());
+    // the cache doesn't know about the units and commodities of a context
+    if (activeParseContext != nullptr ||
+        !useUnitOutputCache.load(std::memory_order_acquire)) {
+        return clean_unit_string(
+            to_string_internal(un, match_flags), un.commodity());
+    }
+    auto generation = unitOutputGeneration.load(std::memory_order_acquire);
+    unit_output_key key(un, match_flags);
+    std::string result;
+    if (unitOutputCache.find(key, generation, result)) {
+        return result;
+    }
+    result =
+        clean_unit_string(to_string_internal(un, match_flags), un.commodity());
+    unitOutputCache.insert(key, generation, result);
+    return result;
 }
 
 std::string
@@ -1972,6 +2891,10 @@ static bool
 the index of the first non-converted character is returned in index*/
 static double
     generateLeadingNumber(const std::string& ustring, size_t& index) noexcept;
+static double generateLeadingNumber(
+    const char* str,
+    std::size_t length,
+    size_t& index) noexcept;
 
 /** generate a number representing the leading portion of a string if the words
 are numerical in nature the index of the first non-converted character is
@@ -1980,98 +2903,263 @@ static double readNumericalWords(const std::string& ustring, size_t& index);
 
 // Detect if a string looks like a number
 static bool looksLikeNumber(const std::string& string, size_t index = 0);
+static bool
+    looksLikeNumber(const char* str, std::size_t length, size_t index);
+
+// the powers of 10 which are exactly representable as a double
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<double, 23> exactPowersOf10{
+    {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22}};
+
+/** convert a decimal number with exact arithmetic if the mantissa and power
+of 10 are both exactly representable, in which case the result is correctly
+rounded.  returns false if the exact conversion is not possible*/
+static bool exactDecimalConversion(
+    std::uint64_t mantissa,
+    int exponent,
+    double& value) noexcept
+{
+    static constexpr std::uint64_t maxExactMantissa{1ULL << 53U};
+    if (mantissa > maxExactMantissa) {
+        return false;
+    }
+    if (exponent < 0) {
+        if (exponent < -22) {
+            return false;
+        }
+        value = static_cast<double>(mantissa) / exactPowersOf10[-exponent];
+        return true;
+    }
+    // shift some of a large exponent into the mantissa if it stays exact
+    while (exponent > 22) {
+        mantissa *= 10U;
+        if (mantissa > maxExactMantissa) {
+            return false;
+        }
+        --exponent;
+    }
+    value = static_cast<double>(mantissa) * exactPowersOf10[exponent];
+    return true;
+}
 
-/** a function very similar to stod that uses the lower level strtod and does
- * things a little smarter for our case
- */
-static double
-    getDoubleFromString(const std::string& ustring, size_t* index) noexcept
+/** a function very similar to stod that works on a string segment and does
+things a little smarter for our case. Decimal numbers are converted without
+using the locale, numbers which cannot be converted exactly and other forms
+such as hex and inf use strtod*/
+static double getDoubleFromString(
+    const char* str,
+    std::size_t length,
+    size_t* index) noexcept
 {
-    char* retloc = nullptr;
-    auto vld = strtold(ustring.c_str(), &retloc);
-    // LCOV_EXCL_START
-    if (retloc == nullptr) {
-        // to the best of my knowledge this should not happen but this is a
-        // weird function sometimes with a lot of platform variations
-        *index = 0;
-        return constants::invalid_conversion;
+    static constexpr int maxMantissaDigits{19};
+    static constexpr int maxExponent{100000};
+
+    std::size_t loc{0};
+    bool negative{false};
+    if (length > 0 && (str[0] == '-' || str[0] == '+')) {
+        negative = (str[0] == '-');
+        ++loc;
+    }
+    const std::size_t digitStart{loc};
+    std::uint64_t mantissa{0};
+    int storedDigits{0};
+    int fractionDigits{0};
+    int exponent{0};
+    bool anyDigits{false};
+    bool truncated{false};
+    bool fraction{false};
+    while (loc < length) {
+        char current = str[loc];
+        if (current == '.' && !fraction) {
+            fraction = true;
+            ++loc;
+            continue;
+        }
+        if (!isDigitCharacter(current)) {
+            break;
+        }
+        anyDigits = true;
+        if (fraction) {
+            ++fractionDigits;
+        }
+        if (mantissa == 0 && current == '0') {
+            // leading zeros only shift the decimal point
+            exponent -= fraction ? 1 : 0;
+        } else if (storedDigits < maxMantissaDigits) {
+            mantissa = mantissa * 10U + static_cast<unsigned>(current - '0');
+            ++storedDigits;
+            exponent -= fraction ? 1 : 0;
+        } else {
+            truncated = true;
+            exponent += fraction ? 0 : 1;
+        }
+        ++loc;
+    }
+    const std::size_t digitEnd{loc};
+    bool otherForm = !anyDigits;
+    // hex numbers are left to strtod
+    if (digitEnd == digitStart + 1 && str[digitStart] == '0' &&
+        loc < length && (str[loc] == 'x' || str[loc] == 'X')) {
+        otherForm = true;
+    }
+    int explicitExponent{0};
+    if (!otherForm && loc + 1 < length &&
+        (str[loc] == 'e' || str[loc] == 'E')) {
+        std::size_t eloc{loc + 1};
+        bool negativeExponent{false};
+        if (str[eloc] == '-' || str[eloc] == '+') {
+            negativeExponent = (str[eloc] == '-');
+            ++eloc;
+        }
+        if (eloc < length && isDigitCharacter(str[eloc])) {
+            while (eloc < length && isDigitCharacter(str[eloc])) {
+                if (explicitExponent < maxExponent) {
+                    explicitExponent =
+                        explicitExponent * 10 + (str[eloc] - '0');
+                }
+                ++eloc;
+            }
+            if (negativeExponent) {
+                explicitExponent = -explicitExponent;
+            }
+            loc = eloc;
+        }
     }
-    // LCOV_EXCL_STOP
-    *index = (retloc - ustring.c_str());
-    // so if it converted anything then we can probably use that value if not
-    // return NaN
-    if (*index == 0) {
-        return constants::invalid_conversion;
+
+    double value{0.0};
+    if (otherForm) {
+        // whitespace, hex, inf, and nan
+        std::string segment(str, length);
+        char* retloc = nullptr;
+        value = std::strtod(segment.c_str(), &retloc);
+        // LCOV_EXCL_START
+        if (retloc == nullptr) {
+            // to the best of my knowledge this should not happen but this is
+            // a weird function sometimes with a lot of platform variations
+            *index = 0;
+            return constants::invalid_conversion;
+        }
+        // LCOV_EXCL_STOP
+        *index = static_cast<size_t>(retloc - segment.c_str());
+        // so if it converted anything then we can probably use that value if
+        // not return NaN
+        if (*index == 0) {
+            return constants::invalid_conversion;
+        }
+    } else {
+        *index = loc;
+        if (mantissa != 0 &&
+            (truncated ||
+             !exactDecimalConversion(
+                 mantissa, exponent + explicitExponent, value))) {
+            // build a locale independent string of the digits for strtod
+            std::string digits;
+            digits.reserve(digitEnd - digitStart + 8);
+            for (std::size_t ii = digitStart; ii < digitEnd; ++ii) {
+                if (str[ii] != '.') {
+                    digits.push_back(str[ii]);
+                }
+            }
+            digits.push_back('e');
+            digits.append(std::to_string(explicitExponent - fractionDigits));
+            value = std::strtod(digits.c_str(), nullptr);
+        }
+        if (negative) {
+            value = -value;
+        }
     }
 
-    if (vld > static_cast<long double>(std::numeric_limits<double>::max())) {
+    if (value > std::numeric_limits<double>::max()) {
         return constants::infinity;
     }
-    if (vld < static_cast<long double>(-std::numeric_limits<double>::max())) {
+    if (value < -std::numeric_limits<double>::max()) {
         return -constants::infinity;
     }
     // floating point min gives you the smallest representable positive value
-    if (std::fabs(vld) <
-        static_cast<long double>(std::numeric_limits<double>::min())) {
+    if (std::fabs(value) < std::numeric_limits<double>::min()) {
         return 0.0;
     }
-    return static_cast<double>(vld);
+    return value;
+}
+
+static double
+    getDoubleFromString(const std::string& ustring, size_t* index) noexcept
+{
+    return getDoubleFromString(ustring.c_str(), ustring.size(), index);
 }
 
 /** generate a value from a single numerical block */
-static double getNumberBlock(const std::string& ustring, size_t& index) noexcept
+static double getNumberBlock(
+    const char* str,
+    std::size_t length,
+    size_t& index) noexcept
 {
     double val{constants::invalid_conversion};
-    if (ustring.front() == '(') {
-        size_t ival{1};
-        if (segmentcheck(ustring, ')', ival)) {
-            if (ival == 2) {
-                index = ival;
-                return 1.0;
-            }
-            bool hasOp = false;
-            for (size_t ii = 1; ii < ival - 1; ++ii) {
-                auto c = ustring[ii];
-                if (c >= '0' && c <= '9') {
-                    continue;
-                }
-                switch (c) {
-                    case '-':
-                    case '.':
-                    case 'e':
-                        break;
-                    case '*':
-                    case '/':
-                    case '^':
-                    case '(':
-                    case ')':
-                        hasOp = true;
-                        break;
-                    default:
-                        return constants::invalid_conversion;
-                }
+    if (length == 0) {
+        return val;
+    }
+    if (str[0] == '(') {
+        // find the matching parenthesis, only numbers and operators are
+        // allowed inside
+        std::size_t close{1};
+        int depth{0};
+        bool hasOp = false;
+        for (; close < length; ++close) {
+            auto c = str[close];
+            if (c >= '0' && c <= '9') {
+                continue;
             }
-            auto substr = ustring.substr(1, ival - 2);
-            size_t ind{0};
-            if (hasOp) {
-                val = generateLeadingNumber(substr, ind);
-            } else {
-                val = getDoubleFromString(substr, &ind);
+            if (c == ')' && depth == 0) {
+                break;
             }
-            if (ind < substr.size()) {
-                return constants::invalid_conversion;
+            switch (c) {
+                case '-':
+                case '.':
+                case 'e':
+                    break;
+                case '(':
+                    ++depth;
+                    hasOp = true;
+                    break;
+                case ')':
+                    --depth;
+                    hasOp = true;
+                    break;
+                case '*':
+                case '/':
+                case '^':
+                    hasOp = true;
+                    break;
+                default:
+                    return constants::invalid_conversion;
             }
-            index = ival;
+        }
+        if (close >= length) {
+            return constants::invalid_conversion;
+        }
+        if (close == 1) {
+            index = 2;
+            return 1.0;
+        }
+        const std::size_t segmentLength{close - 1};
+        size_t ind{0};
+        if (hasOp) {
+            val = generateLeadingNumber(str + 1, segmentLength, ind);
         } else {
+            val = getDoubleFromString(str + 1, segmentLength, &ind);
+        }
+        if (ind < segmentLength) {
             return constants::invalid_conversion;
         }
+        index = close + 1;
     } else {
-        val = getDoubleFromString(ustring, &index);
+        val = getDoubleFromString(str, length, &index);
     }
-    if (!std::isnan(val) && index < ustring.size()) {
-        if (ustring[index] == '^') {
+    if (!std::isnan(val) && index < length) {
+        if (str[index] == '^') {
             size_t nindex{0};
-            double pval = getNumberBlock(ustring.substr(index + 1), nindex);
+            double pval =
+                getNumberBlock(str + index + 1, length - index - 1, nindex);
             if (!std::isnan(pval)) {
                 index += nindex + 1;
                 return std::pow(val, pval);
@@ -2083,19 +3171,22 @@ static double getNumberBlock(const std::string& ustring, size_t& index) noexcept
     return val;
 }
 
-double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
+double generateLeadingNumber(
+    const char* str,
+    std::size_t length,
+    size_t& index) noexcept
 {
     index = 0;
-    double val = getNumberBlock(ustring, index);
+    double val = getNumberBlock(str, length, index);
     if (std::isnan(val)) {
         index = 0;
         return val;
     }
     while (true) {
-        if (index >= ustring.size()) {
+        if (index >= length) {
             return val;
         }
-        switch (ustring[index]) {
+        switch (str[index]) {
             case '.':
             case '-':
             case '+':
@@ -2104,13 +3195,13 @@ double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
             case '/':
             case '*':
             case 'x':
-                if (looksLikeNumber(ustring, index + 1) ||
-                    ustring[index + 1] == '(') {
+                if (looksLikeNumber(str, length, index + 1) ||
+                    (index + 1 < length && str[index + 1] == '(')) {
                     size_t oindex{0};
-                    double res =
-                        getNumberBlock(ustring.substr(index + 1), oindex);
+                    double res = getNumberBlock(
+                        str + index + 1, length - index - 1, oindex);
                     if (!std::isnan(res)) {
-                        if (ustring[index] == '/') {
+                        if (str[index] == '/') {
                             val /= res;
                         } else {
                             val *= res;
@@ -2126,7 +3217,8 @@ double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
                 break;
             case '(': {
                 size_t oindex{0};
-                double res = getNumberBlock(ustring.substr(index), oindex);
+                double res =
+                    getNumberBlock(str + index, length - index, oindex);
                 if (!std::isnan(res)) {
                     val *= res;
                     index = oindex + index + 1;
@@ -2141,6 +3233,11 @@ double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
     }
 }
 
+double generateLeadingNumber(const std::string& ustring, size_t& index) noexcept
+{
+    return generateLeadingNumber(ustring.c_str(), ustring.size(), index);
+}
+
 // this string contains the first two letters of supported numerical words
 // static const std::string first_two =
 //    "on tw th fo fi si se ei ni te el hu mi bi tr ze";
@@ -2314,6 +3411,40 @@ static double readNumericalWords(const std::string& ustring, size_t& index)
     return val;
 }
 
+/** classify the characters in a unit string in a single pass
+@return a combination of the detail::unit_string_class bits*/
+static std::uint32_t classifyUnitString(const std::string& unit_string)
+{
+    // separate flags for each class keep the loop simple to vectorize
+    bool nonAscii{false};
+    bool whitespace{false};
+    bool html{false};
+    bool bracket{false};
+    bool digit{false};
+    bool dot{false};
+    bool multiply{false};
+    for (auto chr : unit_string) {
+        auto val = static_cast<unsigned char>(chr);
+        nonAscii |= (val >= 0x80U);
+        whitespace |=
+            (val == ' ' || val == '\t' || val == '\n' || val == '\r' ||
+             val == '\0');
+        html |= (val == '<' || val == '&');
+        bracket |=
+            (val == '(' || val == ')' || val == '[' || val == ']' ||
+             val == '{' || val == '}');
+        digit |= (val >= '0' && val <= '9');
+        dot |= (val == '.');
+        multiply |= (val == '*');
+    }
+    return (nonAscii ? detail::non_ascii_chars : 0U) |
+        (whitespace ? detail::whitespace_chars : 0U) |
+        (html ? detail::html_chars : 0U) |
+        (bracket ? detail::bracket_chars : 0U) |
+        (digit ? detail::digit_chars : 0U) | (dot ? detail::dot_chars : 0U) |
+        (multiply ? detail::multiply_chars : 0U);
+}
+
 #ifdef ENABLE_UNIT_TESTING
 namespace detail {
     namespace testing {
@@ -2338,6 +3469,11 @@ namespace detail {
             return clean_unit_string(std::move(testString), commodity);
         }
 
+        std::uint32_t testClassifyUnitString(const std::string& unit_string)
+        {
+            return classifyUnitString(unit_string);
+        }
+
         void testAddUnitPower(
             std::string& str,
             const char* unit,
@@ -2570,6 +3706,88 @@ static bool wordModifiers(std::string& unit)
 
 using ckpair = std::pair<const char*, const char*>;
 
+namespace {
+/** a set of the byte values present in a string
+@details used to skip searching for replacement codes which contain a character
+that is not in the string*/
+class character_set {
+  public:
+    character_set() = default;
+    explicit character_set(const char* str) { add(str); }
+    explicit character_set(const std::string& str)
+    {
+        for (auto chr : str) {
+            insert(chr);
+        }
+    }
+    void add(const char* str)
+    {
+        while (*str != '\0') {
+            insert(*str);
+            ++str;
+        }
+    }
+    void insert(char chr)
+    {
+        auto val = static_cast<unsigned char>(chr);
+        bits[val >> 6U] |= (std::uint64_t{1} << (val & 0x3FU));
+    }
+    /// check if all the characters of another set are in this set
+    bool contains(const character_set& other) const
+    {
+        return ((other.bits[0] & ~bits[0]) | (other.bits[1] & ~bits[1]) |
+                (other.bits[2] & ~bits[2]) | (other.bits[3] & ~bits[3])) == 0;
+    }
+
+  private:
+    std::uint64_t bits[4]{0, 0, 0, 0};
+};
+
+/// generate the character sets for the search strings of a replacement table
+template<std::size_t N>
+std::array<character_set, N>
+    codeCharacters(const std::array<ckpair, N>& codes)
+{
+    std::array<character_set, N> sets;
+    for (std::size_t ii = 0; ii < N; ++ii) {
+        sets[ii] = character_set(codes[ii].first);
+    }
+    return sets;
+}
+}  // namespace
+
+/** replace all the occurrences of each code in a table in order
+@details codes with a character not present in the string are skipped without
+searching, a replacement can only add characters to the string so the set of
+present characters is extended with the replacement string
+@return true if any replacement was made*/
+template<std::size_t N>
+static bool replaceCodes(
+    std::string& unit_string,
+    const std::array<ckpair, N>& codes,
+    const std::array<character_set, N>& codeChars)
+{
+    bool changed{false};
+    character_set present(unit_string);
+    for (std::size_t ii = 0; ii < N; ++ii) {
+        if (!present.contains(codeChars[ii])) {
+            continue;
+        }
+        const auto& acode = codes[ii];
+        auto fnd = unit_string.find(acode.first);
+        if (fnd == std::string::npos) {
+            continue;
+        }
+        while (fnd != std::string::npos) {
+            unit_string.replace(fnd, strlen(acode.first), acode.second);
+            fnd = unit_string.find(acode.first, fnd + 1);
+        }
+        present.add(acode.second);
+        changed = true;
+    }
+    return changed;
+}
+
 static const std::unordered_map<std::string, std::string> modifiers{
     ckpair{"internationaltable", "IT"},
     ckpair{"internationalsteamtable", "IT"},
@@ -2912,26 +4130,119 @@ static std::pair<double, size_t>
     return {0.0, 0};
 }
 
-static smap loadDefinedUnits()
-{
-    smap knownUnits{};
-    for (const auto& pr : defined_unit_strings_si) {
-        if (pr.first != nullptr) {
-            knownUnits.emplace(pr.first, pr.second);
+namespace {
+    /** flat table of the defined unit strings
+    @details the names point directly into the static definition arrays so
+    no strings are allocated and a lookup doesn't require a std::string, the
+    index uses open addressing with linear probing into the entry list*/
+    class unit_string_table {
+      public:
+        struct entry {
+            const char* name;
+            std::size_t length;
+            precise_unit un;
+        };
+
+        explicit unit_string_table(std::size_t expectedSize)
+        {
+            std::size_t slotCount{64U};
+            while (slotCount < expectedSize * 2) {
+                slotCount *= 2;
+            }
+            slots.resize(slotCount, slot_data{0U, 0U});
+            entries.reserve(expectedSize);
         }
-    }
-    for (const auto& pr : defined_unit_strings_customary) {
-        if (pr.first != nullptr) {
-            knownUnits.emplace(pr.first, pr.second);
+
+        template<typename ARRAY>
+        void addDefinitions(const ARRAY& definitions)
+        {
+            for (const auto& pr : definitions) {
+                if (pr.first != nullptr) {
+                    insert(pr.first, pr.second);
+                }
+            }
         }
-    }
+
+        /// find a string in the table, returns nullptr if not found
+        const precise_unit* find(const char* str, std::size_t length) const
+        {
+            auto mask = slots.size() - 1;
+            auto hash = hashString(str, length);
+            auto tag = static_cast<std::uint32_t>(hash >> 32U);
+            for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+                const auto& sdata = slots[slot];
+                if (sdata.index == 0U) {
+                    return nullptr;
+                }
+                if (sdata.tag == tag) {
+                    const auto& ent = entries[sdata.index - 1];
+                    if (ent.length == length &&
+                        std::memcmp(ent.name, str, length) == 0) {
+                        return &ent.un;
+                    }
+                }
+            }
+        }
+
+        const std::vector<entry>& values() const { return entries; }
+
+      private:
+        // FNV-1a hash of the string bytes
+        static std::uint64_t hashString(const char* str, std::size_t length)
+        {
+            std::uint64_t hash{0xcbf29ce484222325ULL};
+            for (std::size_t ii = 0; ii < length; ++ii) {
+                hash ^= static_cast<unsigned char>(str[ii]);
+                hash *= 0x100000001b3ULL;
+            }
+            return hash ^ (hash >> 29U);
+        }
+
+        // the first definition of a string takes precedence
+        void insert(const char* name, const precise_unit& un)
+        {
+            auto length = std::strlen(name);
+            auto mask = slots.size() - 1;
+            auto hash = hashString(name, length);
+            auto slot = hash & mask;
+            while (slots[slot].index != 0U) {
+                const auto& ent = entries[slots[slot].index - 1];
+                if (ent.length == length &&
+                    std::memcmp(ent.name, name, length) == 0) {
+                    return;
+                }
+                slot = (slot + 1) & mask;
+            }
+            entries.push_back(entry{name, length, un});
+            slots[slot].tag = static_cast<std::uint32_t>(hash >> 32U);
+            slots[slot].index = static_cast<std::uint32_t>(entries.size());
+        }
+
+        // the upper bits of the hash are stored to skip most mismatches
+        struct slot_data {
+            std::uint32_t tag;
+            std::uint32_t index;
+        };
+        std::vector<entry> entries;
+        std::vector<slot_data> slots;
+    };
+}  // namespace
+
+static unit_string_table loadDefinedUnits()
+{
+    unit_string_table knownUnits(
+        defined_unit_strings_si.size() +
+        defined_unit_strings_customary.size()
 #if !defined(UNITS_DISABLE_NON_ENGLISH_UNITS) ||                               \
     UNITS_DISABLE_NON_ENGLISH_UNITS == 0
-    for (const auto& pr : defined_unit_strings_non_english) {
-        if (pr.first != nullptr) {
-            knownUnits.emplace(pr.first, pr.second);
-        }
-    }
+        + defined_unit_strings_non_english.size()
+#endif
+    );
+    knownUnits.addDefinitions(defined_unit_strings_si);
+    knownUnits.addDefinitions(defined_unit_strings_customary);
+#if !defined(UNITS_DISABLE_NON_ENGLISH_UNITS) ||                               \
+    UNITS_DISABLE_NON_ENGLISH_UNITS == 0
+    knownUnits.addDefinitions(defined_unit_strings_non_english);
 #endif
     return knownUnits;
 }
@@ -2939,7 +4250,7 @@ static smap loadDefinedUnits()
 http://vizier.u-strasbg.fr/vizier/doc/catstd-3.2.htx
 http://unitsofmeasure.org/ucum.html#si
 */
-static const smap base_unit_vals = loadDefinedUnits();
+static const unit_string_table base_unit_vals = loadDefinedUnits();
 
 // LCOV_EXCL_START
 
@@ -3067,7 +4378,8 @@ static bool
 static precise_unit commoditizedUnit(
     const std::string& unit_string,
     precise_unit actUnit,
-    size_t& index)
+    size_t& index,
+    std::uint64_t match_flags)
 {
     auto ccindex = unit_string.find_first_of('{');
     if (ccindex == std::string::npos) {
@@ -3088,7 +4400,7 @@ static precise_unit commoditizedUnit(
         index = ccindex;
         return actUnit * precise_unit(1.0, precise::count, commodities::cell);
     }
-    auto hcode = getCommodity(std::move(commodStr));
+    auto hcode = getCommodity(std::move(commodStr), match_flags);
     index = ccindex;
     return {1.0, actUnit, hcode};
 }
@@ -3113,7 +4425,7 @@ static precise_unit
         static_cast<size_t>(ccindex) + 2, finish - ccindex - 2);
 
     if (ccindex < 0) {
-        return {1.0, precise::one, getCommodity(cstring)};
+        return {1.0, precise::one, getCommodity(cstring, match_flags)};
     }
 
     auto bunit = unit_from_string_internal(
@@ -3145,7 +4457,7 @@ static precise_unit
                 return bunit * tunit->second;
             }
         }
-        return {1.0, bunit, getCommodity(cstring)};
+        return {1.0, bunit, getCommodity(cstring, match_flags)};
     }
     return precise::invalid;
 }
@@ -3205,105 +4517,209 @@ static bool hasAdditionalOps(const std::string& unit_string)
          std::string::npos);
 }
 
-static std::uint64_t hashGen(std::uint64_t index, const std::string& str)
-{
-    return std::hash<std::string>{}(str) ^ std::hash<std::uint64_t>{}(index);
-}
-
-static const std::unordered_map<std::uint64_t, precise_unit> domainSpecificUnit{
-    {hashGen(domains::ucum, "B"), precise::log::bel},
-    {hashGen(domains::ucum, "a"), precise::time::aj},
-    {hashGen(domains::ucum, "year"), precise::time::aj},
-    {hashGen(domains::ucum, "equivalent"), precise::mol},
-    {hashGen(domains::astronomy, "am"), precise::angle::arcmin},
-    {hashGen(domains::astronomy, "as"), precise::angle::arcsec},
-    {hashGen(domains::astronomy, "year"), precise::time::at},
-    {hashGen(domains::cooking, "C"), precise::us::cup},
-    {hashGen(domains::cooking, "T"), precise::us::tbsp},
-    {hashGen(domains::cooking, "c"), precise::us::cup},
-    {hashGen(domains::cooking, "smi"),
-     precise_unit(1.0 / 32.0, precise::us::tsp)},
-    {hashGen(domains::cooking, "scruple"),
-     precise_unit(1.0 / 4.0, precise::us::tsp)},
-    {hashGen(domains::cooking, "t"), precise::us::tsp},
-    {hashGen(domains::cooking, "ds"),
-     precise_unit(1.0 / 16.0, precise::us::tsp)},
-    {hashGen(domains::cooking, "TB"), precise::us::tbsp},
-    {hashGen(domains::surveying, "'"), precise::us::foot},
-    {hashGen(domains::surveying, "`"), precise::us::foot},
-    {hashGen(domains::surveying, u8"\u2032"), precise::us::foot},
-    {hashGen(domains::surveying, "''"), precise::us::inch},
-    {hashGen(domains::surveying, "``"), precise::us::inch},
-    {hashGen(domains::surveying, "\""), precise::us::inch},
-    {hashGen(domains::surveying, u8"\u2033"), precise::us::inch},
-    {hashGen(domains::nuclear, "rad"), precise::cgs::RAD},
-    {hashGen(domains::nuclear, "rd"), precise::cgs::RAD},
-    {hashGen(domains::climate, "kt"), precise::kilo* precise::t},
-    {
-        hashGen(domains::climate, "Sv"),
-        {1e6, precise::m.pow(3) / precise::s},
-    },
-    {hashGen(domains::us_customary, "C"), precise::us::cup},
-    {hashGen(domains::us_customary, "T"), precise::us::tbsp},
-    {hashGen(domains::us_customary, "c"), precise::us::cup},
-    {hashGen(domains::us_customary, "t"), precise::us::tsp},
-    {hashGen(domains::us_customary, "TB"), precise::us::tbsp},
-    {hashGen(domains::us_customary, "'"), precise::us::foot},
-    {hashGen(domains::us_customary, "`"), precise::us::foot},
-    {hashGen(domains::us_customary, u8"\u2032"), precise::us::foot},
-    {hashGen(domains::us_customary, "''"), precise::us::inch},
-    {hashGen(domains::us_customary, "``"), precise::us::inch},
-    {hashGen(domains::us_customary, "\""), precise::us::inch},
-    {hashGen(domains::us_customary, u8"\u2033"), precise::us::inch},
-    {hashGen(domains::us_customary, "smi"),
-     precise_unit(1.0 / 32.0, precise::us::tsp)},
-    {hashGen(domains::us_customary, "scruple"),
-     precise_unit(1.0 / 4.0, precise::us::tsp)},
-    {hashGen(domains::us_customary, "ds"),
-     precise_unit(1.0 / 16.0, precise::us::tsp)},
-    {hashGen(domains::allDomains, "B"), precise::log::bel},
-    {hashGen(domains::allDomains, "a"), precise::time::aj},
-    {hashGen(domains::allDomains, "year"), precise::time::aj},
-    {hashGen(domains::allDomains, "am"), precise::angle::arcmin},
-    {hashGen(domains::allDomains, "as"), precise::angle::arcsec},
-    {hashGen(domains::allDomains, "C"), precise::us::cup},
-    {hashGen(domains::allDomains, "T"), precise::us::tbsp},
-    {hashGen(domains::allDomains, "c"), precise::us::cup},
-    {hashGen(domains::allDomains, "t"), precise::us::tsp},
-    {hashGen(domains::allDomains, "TB"), precise::us::tbsp},
-    {hashGen(domains::allDomains, "rad"), precise::cgs::RAD},
-    {hashGen(domains::allDomains, "kt"), precise::kilo* precise::t},
-    {hashGen(domains::allDomains, "rd"), precise::cgs::RAD},
-    {hashGen(domains::allDomains, "smi"),
-     precise_unit(1.0 / 32.0, precise::us::tsp)},
-    {hashGen(domains::allDomains, "scruple"),
-     precise_unit(1.0 / 4.0, precise::us::tsp)},
-    {hashGen(domains::allDomains, "ds"),
-     precise_unit(1.0 / 16.0, precise::us::tsp)},
-};
+using domain_unit = std::pair<const char*, precise_unit>;
+
+/* the units with a different meaning in a specific domain, each table must be
+sorted by byte value so it can be searched */
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<domain_unit, 4> ucumDomainUnits{{
+    {"B", precise::log::bel},
+    {"a", precise::time::aj},
+    {"equivalent", precise::mol},
+    {"year", precise::time::aj},
+}};
+
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<domain_unit, 3>
+    astronomyDomainUnits{{
+        {"am", precise::angle::arcmin},
+        {"as", precise::angle::arcsec},
+        {"year", precise::time::at},
+    }};
+
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<domain_unit, 8>
+    cookingDomainUnits{{
+        {"C", precise::us::cup},
+        {"T", precise::us::tbsp},
+        {"TB", precise::us::tbsp},
+        {"c", precise::us::cup},
+        {"ds", precise_unit(1.0 / 16.0, precise::us::tsp)},
+        {"scruple", precise_unit(1.0 / 4.0, precise::us::tsp)},
+        {"smi", precise_unit(1.0 / 32.0, precise::us::tsp)},
+        {"t", precise::us::tsp},
+    }};
+
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<domain_unit, 7>
+    surveyingDomainUnits{{
+        {"\"", precise::us::inch},
+        {"'", precise::us::foot},
+        {"''", precise::us::inch},
+        {"`", precise::us::foot},
+        {"``", precise::us::inch},
+        {u8"\u2032", precise::us::foot},
+        {u8"\u2033", precise::us::inch},
+    }};
+
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<domain_unit, 2>
+    nuclearDomainUnits{{
+        {"rad", precise::cgs::RAD},
+        {"rd", precise::cgs::RAD},
+    }};
+
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<domain_unit, 2>
+    climateDomainUnits{{
+        {"Sv", precise_unit(1e6, precise::m.pow(3) / precise::s)},
+        {"kt", precise::kilo * precise::t},
+    }};
+
+// cooking and surveying
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<domain_unit, 15>
+    usCustomaryDomainUnits{{
+        {"\"", precise::us::inch},
+        {"'", precise::us::foot},
+        {"''", precise::us::inch},
+        {"C", precise::us::cup},
+        {"T", precise::us::tbsp},
+        {"TB", precise::us::tbsp},
+        {"`", precise::us::foot},
+        {"``", precise::us::inch},
+        {"c", precise::us::cup},
+        {"ds", precise_unit(1.0 / 16.0, precise::us::tsp)},
+        {"scruple", precise_unit(1.0 / 4.0, precise::us::tsp)},
+        {"smi", precise_unit(1.0 / 32.0, precise::us::tsp)},
+        {"t", precise::us::tsp},
+        {u8"\u2032", precise::us::foot},
+        {u8"\u2033", precise::us::inch},
+    }};
+
+static UNITS_CPP14_CONSTEXPR_OBJECT std::array<domain_unit, 16>
+    allDomainUnits{{
+        {"B", precise::log::bel},
+        {"C", precise::us::cup},
+        {"T", precise::us::tbsp},
+        {"TB", precise::us::tbsp},
+        {"a", precise::time::aj},
+        {"am", precise::angle::arcmin},
+        {"as", precise::angle::arcsec},
+        {"c", precise::us::cup},
+        {"ds", precise_unit(1.0 / 16.0, precise::us::tsp)},
+        {"kt", precise::kilo * precise::t},
+        {"rad", precise::cgs::RAD},
+        {"rd", precise::cgs::RAD},
+        {"scruple", precise_unit(1.0 / 4.0, precise::us::tsp)},
+        {"smi", precise_unit(1.0 / 32.0, precise::us::tsp)},
+        {"t", precise::us::tsp},
+        {"year", precise::time::aj},
+    }};
+
+/// get the table of units specific to a domain, returns false if there is none
+static bool getDomainTable(
+    std::uint64_t domain,
+    const domain_unit*& table,
+    std::size_t& size)
+{
+    switch (domain) {
+        case domains::ucum:
+            table = ucumDomainUnits.data();
+            size = ucumDomainUnits.size();
+            return true;
+        case domains::astronomy:
+            table = astronomyDomainUnits.data();
+            size = astronomyDomainUnits.size();
+            return true;
+        case domains::cooking:
+            table = cookingDomainUnits.data();
+            size = cookingDomainUnits.size();
+            return true;
+        case domains::surveying:
+            table = surveyingDomainUnits.data();
+            size = surveyingDomainUnits.size();
+            return true;
+        case domains::nuclear:
+            table = nuclearDomainUnits.data();
+            size = nuclearDomainUnits.size();
+            return true;
+        case domains::climate:
+            table = climateDomainUnits.data();
+            size = climateDomainUnits.size();
+            return true;
+        case domains::us_customary:
+            table = usCustomaryDomainUnits.data();
+            size = usCustomaryDomainUnits.size();
+            return true;
+        case domains::allDomains:
+            table = allDomainUnits.data();
+            size = allDomainUnits.size();
+            return true;
+        default:
+            return false;
+    }
+}
 
 static precise_unit
     getDomainUnit(std::uint64_t domain, const std::string& unit_string)
 {
-    auto h1 = hashGen(domain, unit_string);
-    auto fnd = domainSpecificUnit.find(h1);
-    return (fnd != domainSpecificUnit.end()) ? fnd->second : precise::invalid;
+    const domain_unit* table{nullptr};
+    std::size_t size{0};
+    if (!getDomainTable(domain, table, size)) {
+        return precise::invalid;
+    }
+    // std::string::compare orders by unsigned byte value like strcmp
+    const auto* fnd = std::lower_bound(
+        table,
+        table + size,
+        unit_string,
+        [](const domain_unit& dunit, const std::string& str) {
+            return str.compare(dunit.first) > 0;
+        });
+    return (fnd != table + size && unit_string.compare(fnd->first) == 0) ?
+        fnd->second :
+        precise::invalid;
 }
+
+#ifdef ENABLE_UNIT_TESTING
+namespace detail {
+    namespace testing {
+        precise_unit
+            testDomainUnit(std::uint64_t domain, const std::string& unit_string)
+        {
+            return getDomainUnit(domain, unit_string);
+        }
+
+        std::vector<std::string> testDomainUnitNames(std::uint64_t domain)
+        {
+            std::vector<std::string> names;
+            const domain_unit* table{nullptr};
+            std::size_t size{0};
+            if (getDomainTable(domain, table, size)) {
+                for (std::size_t ii = 0; ii < size; ++ii) {
+                    names.emplace_back(table[ii].first);
+                }
+            }
+            return names;
+        }
+    }  // namespace testing
+}  // namespace detail
+#endif
+
 static std::uint64_t getCurrentDomain(std::uint64_t match_flags)
 {
     static constexpr std::uint64_t flagMask{0xFFULL};
     std::uint64_t dmn = match_flags & flagMask;
-
-    return (dmn == 0ULL) ? unitsDomain : dmn;
+    if (dmn != 0ULL) {
+        return dmn;
+    }
+    return (activeParseContext != nullptr) ?
+        activeParseContext->domain() :
+        unitsDomain.load(std::memory_order_acquire);
 }
 
 static precise_unit
     get_unit(const std::string& unit_string, std::uint64_t match_flags)
 {
-    if (allowUserDefinedUnits.load(std::memory_order_acquire)) {
-        if (!user_defined_units.empty()) {
-            auto fnd2 = user_defined_units.find(unit_string);
-            if (fnd2 != user_defined_units.end()) {
+    auto registry = userDefinedUnits();
+    if (registry) {
+        if (!registry->units.empty()) {
+            auto fnd2 = registry->units.find(unit_string);
+            if (fnd2 != registry->units.end()) {
                 return fnd2->second;
             }
         }
@@ -3317,9 +4733,10 @@ static precise_unit
         }
     }
 
-    auto fnd = base_unit_vals.find(unit_string);
-    if (fnd != base_unit_vals.end()) {
-        return fnd->second;
+    const auto* fnd =
+        base_unit_vals.find(unit_string.c_str(), unit_string.size());
+    if (fnd != nullptr) {
+        return *fnd;
     }
     // empty string would have been found already
     auto c = unit_string.front();
@@ -3332,7 +4749,10 @@ static precise_unit
                     strtol(unit_string.c_str() + 5, &ptr, 0));
                 if (*ptr == ']') {
                     return commoditizedUnit(
-                        unit_string, precise::generate_custom_unit(num), index);
+                        unit_string,
+                        precise::generate_custom_unit(num),
+                        index,
+                        match_flags);
                 }
             }
         }
@@ -3345,7 +4765,8 @@ static precise_unit
                     return commoditizedUnit(
                         unit_string,
                         precise::generate_custom_count_unit(num),
-                        index);
+                        index,
+                        match_flags);
                 }
             }
         }
@@ -3358,7 +4779,8 @@ static precise_unit
                     return commoditizedUnit(
                         unit_string,
                         precise_unit(precise::custom::equation_unit(num)),
-                        index);
+                        index,
+                        match_flags);
                 }
             }
         }
@@ -3367,33 +4789,37 @@ static precise_unit
 }
 
 // Detect if a string looks like a number
-static bool looksLikeNumber(const std::string& string, size_t index)
+static bool looksLikeNumber(const char* str, std::size_t length, size_t index)
 {
-    if (string.size() <= index) {
+    if (length <= index) {
         return false;
     }
-    if (isDigitCharacter(string[index])) {
+    if (isDigitCharacter(str[index])) {
         return true;
     }
-    if (string.size() < index + 2) {
+    if (length < index + 2) {
         return false;
     }
-    if (string[index] == '.' &&
-        (string[index + 1] >= '0' && string[index + 1] <= '9')) {
+    if (str[index] == '.' && (str[index + 1] >= '0' && str[index + 1] <= '9')) {
         return true;
     }
-    if (string[index] == '-' || string[index] == '+') {
-        if (string[index + 1] >= '0' && string[index + 1] <= '9') {
+    if (str[index] == '-' || str[index] == '+') {
+        if (str[index + 1] >= '0' && str[index + 1] <= '9') {
             return true;
         }
-        if (string.size() >= index + 3 && string[index + 1] == '.' &&
-            (string[index + 2] >= '0' && string[index + 2] <= '9')) {
+        if (length >= index + 3 && str[index + 1] == '.' &&
+            (str[index + 2] >= '0' && str[index + 2] <= '9')) {
             return true;
         }
     }
     return false;
 }
 
+static bool looksLikeNumber(const std::string& string, size_t index)
+{
+    return looksLikeNumber(string.c_str(), string.size(), index);
+}
+
 // Detect if a string looks like an integer
 static bool looksLikeInteger(const std::string& string)
 {
@@ -4252,9 +5678,18 @@ static bool unicodeReplacement(std::string& unit_string)
             ckpair{"\xBC", "(0.25)"},  // (1/4) fraction
             ckpair{"\xBE", "(0.75)"},  // (3/4) fraction
         }};
+    static const auto ucodeCharacters = codeCharacters(ucodeReplacements);
     bool changed{false};
-    for (const auto& ucode : ucodeReplacements) {
+    character_set present(unit_string);
+    for (std::size_t ii = 0; ii < ucodeReplacements.size(); ++ii) {
+        if (!present.contains(ucodeCharacters[ii])) {
+            continue;
+        }
+        const auto& ucode = ucodeReplacements[ii];
         auto fnd = unit_string.find(ucode.first);
+        if (fnd != std::string::npos) {
+            present.add(ucode.second);
+        }
         while (fnd != std::string::npos) {
             std::size_t codelength = strlen(ucode.first);
             if (codelength == 1 && fnd > 0 &&
@@ -4460,6 +5895,9 @@ static bool cleanUnitString(std::string& unit_string, std::uint64_t match_flags)
             ckpair{"Hz^1/2", "rootHertz"},
             ckpair{u8"\u221AHz", "rootHertz"},
         }};
+    static const auto earlyCodeCharacters =
+        codeCharacters(earlyCodeReplacements);
+    static const auto allCodeCharacters = codeCharacters(allCodeReplacements);
 
     static const std::string spchar = std::string(" \t\n\r") + '\0';
     bool changed = false;
@@ -4485,28 +5923,28 @@ static bool cleanUnitString(std::string& unit_string, std::uint64_t match_flags)
         changed = true;
         skipMultiply = true;
     }
+    // the classes of characters present, this can include classes which are
+    // no longer present but never misses one that is
+    auto classes = classifyUnitString(unit_string);
     if (!skipcodereplacement) {
         // Check for unicode or extended characters
-        if (std::any_of(unit_string.begin(), unit_string.end(), [](char x) {
-                return (static_cast<std::uint8_t>(x) & 0x80U) != 0;
-            })) {
+        if ((classes & detail::non_ascii_chars) != 0) {
             if (unicodeReplacement(unit_string)) {
                 changed = true;
+                classes = classifyUnitString(unit_string);
             }
         }
 
         // some code replacement that needs to be done before single character
         // and space replacements
-        for (const auto& acode : earlyCodeReplacements) {
-            auto fnd = unit_string.find(acode.first);
-            while (fnd != std::string::npos) {
-                changed = true;
-                unit_string.replace(fnd, strlen(acode.first), acode.second);
-                fnd = unit_string.find(acode.first, fnd + 1);
-            }
+        if (replaceCodes(
+                unit_string, earlyCodeReplacements, earlyCodeCharacters)) {
+            changed = true;
+            classes = classifyUnitString(unit_string);
         }
 
-        if (unit_string.find_first_of(spchar) != std::string::npos) {
+        if ((classes & detail::whitespace_chars) != 0 &&
+            unit_string.find_first_of(spchar) != std::string::npos) {
             // deal with some particular string with a space in them
             std::size_t reploc{0};
             // clean up some "per" words
@@ -4558,9 +5996,11 @@ static bool cleanUnitString(std::string& unit_string, std::uint64_t match_flags)
                 return true;
                 // LCOV_EXCL_STOP
             }
+            classes = classifyUnitString(unit_string);
+        }
+        if ((classes & detail::digit_chars) != 0) {
+            checkPowerOf10(unit_string);
         }
-
-        checkPowerOf10(unit_string);
     } else {
         auto fndP = unit_string.find("of(");
         if (fndP != std::string::npos) {
@@ -4574,7 +6014,7 @@ static bool cleanUnitString(std::string& unit_string, std::uint64_t match_flags)
         }
     }
 
-    if (!skipcodereplacement) {
+    if (!skipcodereplacement && (classes & detail::multiply_chars) != 0) {
         // ** means power in some environments
         std::size_t loc{0};
         if (ReplaceStringInPlace(unit_string, "**", 2, "^", 1, loc)) {
@@ -4584,21 +6024,21 @@ static bool cleanUnitString(std::string& unit_string, std::uint64_t match_flags)
     if ((match_flags & case_insensitive) != 0) {
         ciConversion(unit_string);
         changed = true;
+        classes = classifyUnitString(unit_string);
     }
     if (!skipcodereplacement) {
         // deal with some html stuff
-        auto bloc = unit_string.find_last_of('<');
-        if (bloc != std::string::npos) {
-            htmlCodeReplacement(unit_string);
+        if ((classes & detail::html_chars) != 0) {
+            auto bloc = unit_string.find_last_of('<');
+            if (bloc != std::string::npos) {
+                htmlCodeReplacement(unit_string);
+                classes = classifyUnitString(unit_string);
+            }
         }
         // some abbreviations and other problematic code replacements
-        for (const auto& acode : allCodeReplacements) {
-            auto fnd = unit_string.find(acode.first);
-            while (fnd != std::string::npos) {
-                changed = true;
-                unit_string.replace(fnd, strlen(acode.first), acode.second);
-                fnd = unit_string.find(acode.first, fnd + 1);
-            }
+        if (replaceCodes(unit_string, allCodeReplacements, allCodeCharacters)) {
+            changed = true;
+            classes = classifyUnitString(unit_string);
         }
     }
     if (unit_string.size() >= 2) {
@@ -4635,17 +6075,22 @@ static bool cleanUnitString(std::string& unit_string, std::uint64_t match_flags)
     }
     if (!skipcodereplacement) {
         // handle dot notation for multiplication
-        auto dotloc = unit_string.find_last_of('.');
+        auto dotloc = (classes & detail::dot_chars) != 0 ?
+            unit_string.find_last_of('.') :
+            std::string::npos;
         if (dotloc < std::string::npos) {
             // strings always have a null pointer at the end
             if (!isDigitCharacter(unit_string[dotloc + 1])) {
                 cleanDotNotation(unit_string, match_flags);
                 changed = true;
+                classes = classifyUnitString(unit_string);
             }
         }
 
         // clear empty parenthesis
-        auto fndP = unit_string.find("()");
+        auto fndP = (classes & detail::bracket_chars) != 0 ?
+            unit_string.find("()") :
+            std::string::npos;
         while (fndP != std::string::npos) {
             if (unit_string.size() > fndP + 2) {
                 if (unit_string[fndP + 2] == '^') {
@@ -4660,7 +6105,9 @@ static bool cleanUnitString(std::string& unit_string, std::uint64_t match_flags)
         }
         // clear empty brackets, this would indicate commodities but if
         // empty there is no commodity
-        clearEmptySegments(unit_string);
+        if ((classes & (detail::bracket_chars | detail::html_chars)) != 0) {
+            clearEmptySegments(unit_string);
+        }
         cleanUpPowersOfOne(unit_string);
         if (unit_string.empty()) {
             unit_string.push_back('1');
@@ -4844,32 +6291,28 @@ static bool cleanUnitStringPhase2(std::string& unit_string)
     return changed || (len != unit_string.length());
 }
 
-static precise_unit
-    unit_quick_match(std::string unit_string, std::uint64_t match_flags)
+// the quick match operations on a string that doesn't need cleaning, any
+// modified strings are only generated if the simple check fails
+static precise_unit unit_quick_match_clean(
+    const std::string& unit_string,
+    std::uint64_t match_flags)
 {
-    if ((match_flags & case_insensitive) != 0) {  // if not a case insensitive
-                                                  // matching process just do a
-                                                  // quick scan first
-        cleanUnitString(unit_string, match_flags);
-    }
     auto retunit = get_unit(unit_string, match_flags);
     if (is_valid(retunit)) {
         return retunit;
     }
-    if (unit_string.size() > 2 &&
-        unit_string.back() == 's') {  // if the string is of length two this
-                                      // is too risky to try since there
-                                      // would be many incorrect matches
-        unit_string.pop_back();
-        retunit = get_unit(unit_string, match_flags);
+    auto len = unit_string.size();
+    if (len > 2 && unit_string.back() == 's') {  // if the string is of length
+                                                 // two this is too risky to
+                                                 // try since there would be
+                                                 // many incorrect matches
+        retunit = get_unit(unit_string.substr(0, len - 1), match_flags);
         if (is_valid(retunit)) {
             return retunit;
         }
     } else if (unit_string.front() == '[' && unit_string.back() == ']') {
-        unit_string.pop_back();
-        if (unit_string.back() != 'U' && unit_string.back() != 'u') {
-            unit_string.erase(unit_string.begin());
-            retunit = get_unit(unit_string, match_flags);
+        if (unit_string[len - 2] != 'U' && unit_string[len - 2] != 'u') {
+            retunit = get_unit(unit_string.substr(1, len - 2), match_flags);
             if (is_valid(retunit)) {
                 return retunit;
             }
@@ -4878,6 +6321,20 @@ static precise_unit
     return precise::invalid;
 }
 
+static precise_unit unit_quick_match(
+    const std::string& unit_string,
+    std::uint64_t match_flags)
+{
+    if ((match_flags & case_insensitive) != 0) {  // if not a case insensitive
+                                                  // matching process just do a
+                                                  // quick scan first
+        std::string cleaned = unit_string;
+        cleanUnitString(cleaned, match_flags);
+        return unit_quick_match_clean(cleaned, match_flags);
+    }
+    return unit_quick_match_clean(unit_string, match_flags);
+}
+
 static inline std::uint64_t getMinPartitionSize(std::uint64_t match_flags)
 {
     return (match_flags & minimum_partition_size7) >>
@@ -4915,7 +6372,7 @@ static precise_unit
     if (fnd != std::string::npos) {
         std::string ustring = unit_string;
         ustring.erase(fnd, 5);
-        bunit = unit_from_string_internal(ustring, match_flags);
+        bunit = unit_from_string_internal(std::move(ustring), match_flags);
         if (is_valid(bunit)) {
             return precise::m * bunit;
         }
@@ -4965,13 +6422,10 @@ static precise_unit tryUnitPartitioning(
     const std::string& unit_string,
     std::uint64_t match_flags)
 {
-    std::string ustring = unit_string;
-
     auto mret = getPrefixMultiplierWord(unit_string);
     if (mret.first != 0.0) {
-        ustring = unit_string.substr(mret.second);
-
-        auto retunit = unit_from_string_internal(ustring, match_flags);
+        auto retunit = unit_from_string_internal(
+            unit_string.substr(mret.second), match_flags);
         if (is_valid(retunit)) {
             return {mret.first, retunit};
         }
@@ -4981,7 +6435,7 @@ static precise_unit tryUnitPartitioning(
     // a newton(N) in front is somewhat common
     // try a round with just a quick partition
     size_t part = (unit_string.front() == 'N') ? 1 : 3;
-    ustring = unit_string.substr(0, part);
+    std::string ustring = unit_string.substr(0, part);
     if (ustring.back() == '(' || ustring.back() == '[' ||
         ustring.back() == '{') {
         part = 1;
@@ -5110,7 +6564,9 @@ static precise_unit tryUnitPartitioning(
 /** Some standards allow for custom units usually in brackets with 'U or U
  * at the end
  */
-static precise_unit checkForCustomUnit(const std::string& unit_string)
+static precise_unit checkForCustomUnit(
+    const std::string& unit_string,
+    std::uint64_t match_flags)
 {
     size_t loc = std::string::npos;
     bool index = false;
@@ -5136,7 +6592,7 @@ static precise_unit checkForCustomUnit(const std::string& unit_string)
         auto csub = unit_string.substr(1, loc - 1);
 
         if (index) {
-            auto hcode = getCommodity(csub);
+            auto hcode = getCommodity(csub, match_flags);
             return {1.0, precise::generate_custom_count_unit(0), hcode};
         }
 
@@ -5373,12 +6829,356 @@ static precise_unit
     return precise::invalid;
 }
 
+namespace {
+    /// key for caching the results of unit string interpretation
+    struct unit_string_key {
+        unit_string_key(
+            std::string ustring,
+            std::uint64_t flags,
+            std::uint64_t dmn) :
+            str(std::move(ustring)), match_flags(flags), domain(dmn),
+            hash(std::hash<std::string>{}(str) ^
+                 std::hash<std::uint64_t>{}(flags ^ (dmn << 56U)))
+        {
+        }
+        std::string str;
+        std::uint64_t match_flags;
+        std::uint64_t domain;
+        std::size_t hash;
+        bool operator==(const unit_string_key& other) const
+        {
+            return match_flags == other.match_flags &&
+                domain == other.domain && str == other.str;
+        }
+    };
+}  // namespace
+
+static sharded_lru_cache<unit_string_key, precise_unit> unitStringCache;
+static std::atomic<bool> useUnitStringCache{false};
+
+void enableUnitStringCache(std::size_t capacity)
+{
+    unitStringCache.setCapacity(capacity);
+    useUnitStringCache.store(capacity > 0, std::memory_order_release);
+}
+
+void disableUnitStringCache()
+{
+    useUnitStringCache.store(false, std::memory_order_release);
+    unitStringCache.setCapacity(0);
+}
+
+void clearUnitStringCache()
+{
+    unitStringCache.clear();
+}
+
+cache_statistics getUnitStringCacheStatistics()
+{
+    return unitStringCache.statistics();
+}
+
 precise_unit
     unit_from_string(std::string unit_string, std::uint64_t match_flags)
 {
+    if (activeParseContext != nullptr) {
+        // a nested parse of a string while a context is in use
+        return unit_from_string(
+            *activeParseContext, std::move(unit_string), match_flags);
+    }
     // always allow the code replacements on first run
     match_flags &= (~skip_code_replacements);
-    return unit_from_string_internal(std::move(unit_string), match_flags);
+    if (!useUnitStringCache.load(std::memory_order_acquire)) {
+        return unit_from_string_internal(std::move(unit_string), match_flags);
+    }
+    auto generation = stringParseGeneration.load(std::memory_order_acquire);
+    unit_string_key key(
+        std::move(unit_string), match_flags, getCurrentDomain(match_flags));
+    precise_unit retunit;
+    if (unitStringCache.find(key, generation, retunit)) {
+        return retunit;
+    }
+    retunit = unit_from_string_internal(key.str, match_flags);
+    unitStringCache.insert(std::move(key), generation, retunit);
+    return retunit;
+}
+
+namespace detail {
+    /// the cache of strings parsed with a parse_context
+    struct parse_context_cache {
+        sharded_lru_cache<unit_string_key, precise_unit> results;
+    };
+}  // namespace detail
+
+parse_context::parse_context() :
+    parse_context(getDefaultDomain(), getDefaultMatchFlags())
+{
+}
+
+parse_context::parse_context(
+    std::uint64_t domain,
+    std::uint64_t default_flags) : domain_(domain), flags_(default_flags)
+{
+}
+
+/// copy the tables of a context so they can be modified
+static std::shared_ptr<detail::parse_context_tables> copyTables(
+    const std::shared_ptr<const detail::parse_context_tables>& tables)
+{
+    return (tables) ? std::make_shared<detail::parse_context_tables>(*tables) :
+                      std::make_shared<detail::parse_context_tables>();
+}
+
+void parse_context::replace_tables(
+    std::shared_ptr<const detail::parse_context_tables> tables)
+{
+    tables_ = std::move(tables);
+    if (cache_) {
+        // copies of the context may still be using the old cache
+        enable_cache(cache_->results.statistics().capacity);
+    }
+}
+
+void parse_context::add_unit(const std::string& name, const precise_unit& un)
+{
+    auto tables = copyTables(tables_);
+    tables->registry.names[unit_cast(un)] = name;
+    tables->registry.units[name] = un;
+    replace_tables(std::move(tables));
+}
+
+void parse_context::add_input_unit(
+    const std::string& name,
+    const precise_unit& un)
+{
+    auto tables = copyTables(tables_);
+    tables->registry.units[name] = un;
+    replace_tables(std::move(tables));
+}
+
+void parse_context::add_output_unit(
+    const std::string& name,
+    const precise_unit& un)
+{
+    auto tables = copyTables(tables_);
+    tables->registry.names[unit_cast(un)] = name;
+    replace_tables(std::move(tables));
+}
+
+void parse_context::remove_unit(const std::string& name)
+{
+    if (!tables_) {
+        return;
+    }
+    auto tables = copyTables(tables_);
+    auto& registry = tables->registry;
+    auto fnd = registry.units.find(name);
+    if (fnd != registry.units.end()) {
+        registry.names.erase(unit_cast(fnd->second));
+        registry.units.erase(fnd);
+    } else {
+        for (const auto& udun : registry.names) {
+            if (udun.second == name) {
+                registry.names.erase(udun.first);
+                break;
+            }
+        }
+    }
+    replace_tables(std::move(tables));
+}
+
+void parse_context::clear_units()
+{
+    if (!tables_) {
+        return;
+    }
+    auto tables = copyTables(tables_);
+    tables->registry.units.clear();
+    tables->registry.names.clear();
+    replace_tables(std::move(tables));
+}
+
+void parse_context::add_commodity(std::string comm, std::uint32_t code)
+{
+    std::transform(comm.begin(), comm.end(), comm.begin(), ::tolower);
+    auto tables = copyTables(tables_);
+    tables->commodityNames.emplace(code, comm);
+    tables->commodities.emplace(std::move(comm), code);
+    replace_tables(std::move(tables));
+}
+
+void parse_context::clear_commodities()
+{
+    if (!tables_) {
+        return;
+    }
+    auto tables = copyTables(tables_);
+    tables->commodities.clear();
+    tables->commodityNames.clear();
+    replace_tables(std::move(tables));
+}
+
+void parse_context::enable_cache(std::size_t capacity)
+{
+    if (capacity == 0) {
+        disable_cache();
+        return;
+    }
+    cache_ = std::make_shared<detail::parse_context_cache>();
+    cache_->results.setCapacity(capacity);
+}
+
+void parse_context::disable_cache()
+{
+    cache_.reset();
+}
+
+cache_statistics parse_context::get_cache_statistics() const
+{
+    return (cache_) ? cache_->results.statistics() : cache_statistics{};
+}
+
+precise_unit unit_from_string(
+    const parse_context& context,
+    std::string unit_string,
+    std::uint64_t match_flags)
+{
+    context_scope scope(context);
+    match_flags &= (~skip_code_replacements);
+    auto* cache = detail::parse_context_access::cache(context);
+    if (cache == nullptr) {
+        return unit_from_string_internal(std::move(unit_string), match_flags);
+    }
+    // the cache is replaced when the tables change so there are no
+    // generations
+    unit_string_key key(
+        std::move(unit_string), match_flags, getCurrentDomain(match_flags));
+    precise_unit retunit;
+    if (cache->results.find(key, 0U, retunit)) {
+        return retunit;
+    }
+    retunit = unit_from_string_internal(key.str, match_flags);
+    cache->results.insert(std::move(key), 0U, retunit);
+    return retunit;
+}
+
+std::string to_string(
+    const parse_context& context,
+    const precise_unit& units,
+    std::uint64_t match_flags)
+{
+    context_scope scope(context);
+    return to_string(units, match_flags);
+}
+
+namespace {
+/** table of the results of the nested parses made while parsing a unit string
+@details splitting on operators and partitioning run together strings reach the
+same segments with the same flags many times from different split points and
+recursion levels.  Once a parse makes more than a few nested parses the results
+are stored so each distinct segment is parsed only once.  The table exists for
+the duration of the outermost parse so the results cannot become stale from
+changes to the user defined units or flags between parses.
+*/
+class segment_table {
+  public:
+    /// get the stored result for a key
+    const precise_unit* find(const std::string& key) const
+    {
+        auto fnd = results().find(key);
+        return (fnd != results().end()) ? &fnd->second : nullptr;
+    }
+    void store(std::string key, const precise_unit& result)
+    {
+        results().emplace(std::move(key), result);
+        stored = true;
+    }
+    /// generate the key for a segment, the flags are part of the key as they
+    /// include the recursion counters which change the result
+    static std::string
+        makeKey(const std::string& segment, std::uint64_t match_flags)
+    {
+        std::string key;
+        key.reserve(segment.size() + sizeof(match_flags));
+        key.append(
+            reinterpret_cast<const char*>(&match_flags), sizeof(match_flags));
+        key.append(segment);
+        return key;
+    }
+    /// mark the start of a parse, returns true if it is the outermost parse
+    bool enter()
+    {
+        ++nestedParses;
+        return depth++ == 0;
+    }
+    /// mark the end of a parse, the results are cleared after the outermost
+    void exit()
+    {
+        if (--depth == 0) {
+            nestedParses = 0;
+            if (stored) {
+                results().clear();
+                stored = false;
+            }
+        }
+    }
+    /// check if the nested parses should be stored, simple strings make only
+    /// a few nested parses and are not worth the allocations
+    bool active() const { return nestedParses > memoThreshold; }
+
+  private:
+    /// the results are separate so the counters need no initialization
+    static std::unordered_map<std::string, precise_unit>& results()
+    {
+        thread_local std::unordered_map<std::string, precise_unit> segments;
+        return segments;
+    }
+    static constexpr int memoThreshold{64};
+    int depth;
+    int nestedParses;
+    bool stored;
+};
+
+thread_local segment_table parsedSegments{};
+
+/// scope guard tracking the parse depth in the segment table
+class segment_scope {
+  public:
+    segment_scope() : outermost(parsedSegments.enter()) {}
+    ~segment_scope() { parsedSegments.exit(); }
+    segment_scope(const segment_scope&) = delete;
+    segment_scope& operator=(const segment_scope&) = delete;
+
+    const bool outermost;
+};
+}  // namespace
+
+static precise_unit unit_from_string_segment(
+    std::string unit_string,
+    std::uint64_t match_flags);
+
+/** parse a unit string, nested parses of a string and flags seen earlier in
+the same outermost parse reuse the previous result
+*/
+static precise_unit unit_from_string_internal(
+    std::string unit_string,
+    std::uint64_t match_flags)
+{
+    segment_scope scope;
+    if (scope.outermost || !parsedSegments.active()) {
+        // the top level string is only parsed once and simple strings do
+        // not need the table
+        return unit_from_string_segment(std::move(unit_string), match_flags);
+    }
+    auto key = segment_table::makeKey(unit_string, match_flags);
+    const auto* fnd = parsedSegments.find(key);
+    if (fnd != nullptr) {
+        return *fnd;
+    }
+    auto retunit =
+        unit_from_string_segment(std::move(unit_string), match_flags);
+    parsedSegments.store(std::move(key), retunit);
+    return retunit;
 }
 
 // Step 1.  Check if the string matches something in the map
@@ -5392,7 +7192,7 @@ precise_unit
 // Check if the first character is upper case and if so and the string is
 // long make it lower case. Step 9.  Check to see if it is a number of some
 // kind and make numerical unit. Step 10. Return an error unit.
-static precise_unit unit_from_string_internal(
+static precise_unit unit_from_string_segment(
     std::string unit_string,
     std::uint64_t match_flags)
 {
@@ -5437,15 +7237,16 @@ static precise_unit unit_from_string_internal(
     if (unit_string.front() == '{' && unit_string.back() == '}') {
         if (unit_string.find_last_of('}', unit_string.size() - 2) ==
             std::string::npos) {
-            retunit = checkForCustomUnit(unit_string);
+            retunit = checkForCustomUnit(unit_string, match_flags);
             if (!is_error(retunit)) {
                 return retunit;
             }
             size_t index{0};
-            return commoditizedUnit(unit_string, precise::one, index);
+            return commoditizedUnit(
+                unit_string, precise::one, index, match_flags);
         }
     }
-    std::string ustring = unit_string;
+    std::string ustring;
     // catch a preceding number on the unit
     if (looksLikeNumber(unit_string)) {
         if (unit_string.front() != '1' ||
@@ -5468,7 +7269,8 @@ static precise_unit unit_from_string_internal(
             }
             if ((match_flags & no_commodities) == 0 &&
                 unit_string[index] == '{') {
-                front_unit = commoditizedUnit(unit_string, front_unit, index);
+                front_unit = commoditizedUnit(
+                    unit_string, front_unit, index, match_flags);
                 if (index >= unit_string.length()) {
                     return front_unit;
                 }
@@ -5488,7 +7290,8 @@ static precise_unit unit_from_string_internal(
                         return precise::invalid;
                     }
                     auto commodity = getCommodity(
-                        unit_string.substr(index + 1, cparen - index - 1));
+                        unit_string.substr(index + 1, cparen - index - 1),
+                        match_flags);
                     front_unit.commodity(commodity);
                     if (cparen < unit_string.size()) {
                         retunit = unit_from_string_internal(
@@ -5503,7 +7306,8 @@ static precise_unit unit_from_string_internal(
                     if (is_valid(retunit)) {
                         return front_unit * retunit;
                     }
-                    auto commodity = getCommodity(unit_string.substr(index));
+                    auto commodity =
+                        getCommodity(unit_string.substr(index), match_flags);
                     front_unit.commodity(commodity);
                     return front_unit;
                 }
@@ -5656,7 +7460,7 @@ static precise_unit unit_from_string_internal(
                     ustring = unit_string;
                     ustring[0] += 32;
                     retunit = unit_from_string_internal(
-                        ustring,
+                        std::move(ustring),
                         (match_flags & (~case_insensitive)) |
                             skip_partition_check);
                     if (!is_error(retunit)) {
@@ -5892,7 +7696,7 @@ static precise_unit unit_from_string_internal(
         }
     }
 
-    retunit = checkForCustomUnit(unit_string);
+    retunit = checkForCustomUnit(unit_string, match_flags);
     if (!is_error(retunit)) {
         return retunit;
     }
@@ -5922,18 +7726,17 @@ static precise_unit unit_from_string_internal(
     return precise::invalid;
 }  // namespace UNITS_NAMESPACE
 
-precise_measurement measurement_from_string(
-    std::string measurement_string,
-    std::uint64_t match_flags)
+/** clean a measurement string and get the leading number, the index of the
+start of the unit is returned in loc*/
+static double splitMeasurementString(
+    std::string& measurement_string,
+    std::uint64_t match_flags,
+    size_t& loc)
 {
-    if (measurement_string.empty()) {
-        return {};
-    }
     // do a cleaning first to get rid of spaces and other issues
-    match_flags &= (~skip_code_replacements);
     cleanUnitString(measurement_string, match_flags);
 
-    size_t loc{0};
+    loc = 0;
     auto val = generateLeadingNumber(measurement_string, loc);
     if (loc == 0) {
         val = readNumericalWords(measurement_string, loc);
@@ -5941,16 +7744,30 @@ precise_measurement measurement_from_string(
     if (loc == 0) {
         val = 1.0;
     }
-    if (loc >= measurement_string.length()) {
-        return {val, precise::one};
-    }
-    bool checkCurrency = (loc == 0);
-    auto ustring = measurement_string.substr(loc);
+    return val;
+}
+
+// get the unit from the portion of a measurement string after the number
+static precise_unit
+    measurementUnit(std::string ustring, std::uint64_t match_flags)
+{
     auto validString = checkValidUnitString(ustring, match_flags);
-    auto un = (validString) ?
+    return (validString) ?
         unit_from_string_internal(
             std::move(ustring), match_flags | skip_code_replacements) :
         precise::invalid;
+}
+
+/** generate the measurement from a split measurement string and the unit
+from the portion after the number*/
+static precise_measurement assembleMeasurement(
+    std::string& measurement_string,
+    double val,
+    size_t loc,
+    const precise_unit& un,
+    std::uint64_t match_flags)
+{
+    bool checkCurrency = (loc == 0);
     if (!is_error(un)) {
         if (checkCurrency) {
             if (un.base_units() == precise::currency.base_units()) {
@@ -5990,6 +7807,143 @@ precise_measurement measurement_from_string(
     return {val, precise::invalid};
 }
 
+precise_measurement measurement_from_string(
+    std::string measurement_string,
+    std::uint64_t match_flags)
+{
+    if (measurement_string.empty()) {
+        return {};
+    }
+    match_flags &= (~skip_code_replacements);
+    size_t loc{0};
+    auto val = splitMeasurementString(measurement_string, match_flags, loc);
+    if (loc >= measurement_string.length()) {
+        return {val, precise::one};
+    }
+    auto un = measurementUnit(measurement_string.substr(loc), match_flags);
+    return assembleMeasurement(measurement_string, val, loc, un, match_flags);
+}
+
+precise_measurement measurement_from_string(
+    const parse_context& context,
+    std::string measurement_string,
+    std::uint64_t match_flags)
+{
+    context_scope scope(context);
+    return measurement_from_string(std::move(measurement_string), match_flags);
+}
+
+std::vector<bool> measurement_from_string(
+    const std::string* measurement_strings,
+    std::size_t size,
+    precise_measurement* output,
+    std::uint64_t match_flags)
+{
+    std::vector<bool> valid(size, false);
+    match_flags &= (~skip_code_replacements);
+    // the unit for each distinct unit string in the batch
+    std::unordered_map<std::string, precise_unit> units;
+    // columns usually repeat the same unit so check the last one first
+    const std::pair<const std::string, precise_unit>* last{nullptr};
+    std::string measurement_string;
+    for (std::size_t ii = 0; ii < size; ++ii) {
+        if (measurement_strings[ii].empty()) {
+            output[ii] = precise_measurement{};
+            continue;
+        }
+        measurement_string = measurement_strings[ii];
+        size_t loc{0};
+        auto val =
+            splitMeasurementString(measurement_string, match_flags, loc);
+        if (loc >= measurement_string.length()) {
+            output[ii] = precise_measurement{val, precise::one};
+            valid[ii] = true;
+            continue;
+        }
+        if (last == nullptr ||
+            measurement_string.compare(loc, std::string::npos, last->first) !=
+                0) {
+            auto ustring = measurement_string.substr(loc);
+            auto fnd = units.find(ustring);
+            if (fnd == units.end()) {
+                auto un = measurementUnit(ustring, match_flags);
+                fnd = units.emplace(std::move(ustring), un).first;
+            }
+            last = &(*fnd);
+        }
+        output[ii] = assembleMeasurement(
+            measurement_string, val, loc, last->second, match_flags);
+        valid[ii] = !is_error(output[ii].units());
+    }
+    return valid;
+}
+
+std::vector<bool> measurement_from_string(
+    const std::string* measurement_strings,
+    std::size_t size,
+    unsigned int thread_count,
+    precise_measurement* output,
+    std::uint64_t match_flags)
+{
+    // each thread should get enough strings to be worth starting
+    static constexpr std::size_t minimumChunkSize{32U};
+    if (thread_count == 0) {
+        thread_count = (std::max)(std::thread::hardware_concurrency(), 1U);
+    }
+    auto chunks = (std::min)(
+        static_cast<std::size_t>(thread_count),
+        (size + minimumChunkSize - 1) / minimumChunkSize);
+    if (chunks <= 1) {
+        return measurement_from_string(
+            measurement_strings, size, output, match_flags);
+    }
+    std::vector<std::vector<bool>> chunkValid(chunks);
+    std::vector<std::exception_ptr> errors(chunks);
+    auto parseChunk = [&](std::size_t chunk) {
+        auto start = size * chunk / chunks;
+        auto stop = size * (chunk + 1) / chunks;
+        try {
+            chunkValid[chunk] = measurement_from_string(
+                measurement_strings + start,
+                stop - start,
+                output + start,
+                match_flags);
+        }
+        catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+    std::size_t started{1};
+    try {
+        for (; started < chunks; ++started) {
+            threads.emplace_back(parseChunk, started);
+        }
+    }
+    catch (const std::system_error&) {
+        // run anything that could not get a thread on this one
+    }
+    parseChunk(0);
+    for (std::size_t chunk = started; chunk < chunks; ++chunk) {
+        parseChunk(chunk);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& chunkError : errors) {
+        if (chunkError) {
+            std::rethrow_exception(chunkError);
+        }
+    }
+    std::vector<bool> valid;
+    valid.reserve(size);
+    for (const auto& chunk : chunkValid) {
+        valid.insert(valid.end(), chunk.begin(), chunk.end());
+    }
+    return valid;
+}
+
 uncertain_measurement uncertain_measurement_from_string(
     const std::string& measurement_string,
     std::uint64_t match_flags)
@@ -6193,11 +8147,30 @@ precise_unit default_unit(std::string unit_type)
 namespace detail {
     const std::unordered_map<std::string, precise_unit>& getUnitStringMap()
     {
-        return base_unit_vals;
+        static const smap unitStringMap = []() {
+            smap knownUnits{};
+            for (const auto& ent : base_unit_vals.values()) {
+                knownUnits.emplace(
+                    std::string(ent.name, ent.length), ent.un);
+            }
+            return knownUnits;
+        }();
+        return unitStringMap;
+    }
+    const precise_unit* lookupUnitString(const char* str, std::size_t length)
+    {
+        return base_unit_vals.find(str, length);
     }
     const std::unordered_map<unit, const char*>& getUnitNameMap()
     {
-        return base_unit_names;
+        static const std::unordered_map<unit, const char*> unitNameMap = []() {
+            std::unordered_map<unit, const char*> knownNames{};
+            for (const auto& ent : base_unit_names.values()) {
+                knownNames.emplace(ent.un, ent.name);
+            }
+            return knownNames;
+        }();
+        return unitNameMap;
     }
 }  // namespace detail
 #endif
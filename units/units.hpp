@@ -7,10 +7,13 @@ SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 #include "unit_definitions.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #ifdef ENABLE_UNIT_MAP_ACCESS
 #include <unordered_map>
@@ -271,6 +274,308 @@ double convert(
     return convert(val, start, result * pu) * base;
 }
 
+namespace detail {
+    /// multiply each value by a common scale factor
+    inline void scaleValues(
+        const double* input,
+        double* output,
+        std::size_t size,
+        double scale)
+    {
+        for (std::size_t ii = 0; ii < size; ++ii) {
+            output[ii] = input[ii] * scale;
+        }
+    }
+    /// multiply each value by a common scale factor and add an offset
+    inline void scaleOffsetValues(
+        const double* input,
+        double* output,
+        std::size_t size,
+        double scale,
+        double offset)
+    {
+        for (std::size_t ii = 0; ii < size; ++ii) {
+            output[ii] = input[ii] * scale + offset;
+        }
+    }
+    /// invert each value after multiplying by a common scale factor
+    inline void invertValues(
+        const double* input,
+        double* output,
+        std::size_t size,
+        double scale)
+    {
+        for (std::size_t ii = 0; ii < size; ++ii) {
+            output[ii] = 1.0 / (input[ii] * scale);
+        }
+    }
+#ifndef UNITS_HEADER_ONLY
+    /** versions of the value kernels compiled into the library
+    @details on platforms that support it these select an implementation for
+    the instruction set available at run time*/
+    UNITS_EXPORT void convertLinearValues(
+        const double* input,
+        double* output,
+        std::size_t size,
+        double scale);
+    UNITS_EXPORT void convertAffineValues(
+        const double* input,
+        double* output,
+        std::size_t size,
+        double scale,
+        double offset);
+    UNITS_EXPORT void convertInverseValues(
+        const double* input,
+        double* output,
+        std::size_t size,
+        double scale);
+#endif
+}  // namespace detail
+
+/** Class holding a precompiled conversion between two units
+@details the checks made by convert are evaluated once on construction and the
+conversion is reduced to a few coefficients, so applying the converter to a
+value does not depend on the unit metadata.  Conversions that would depend on
+per unit base values are not supported by this class.
+*/
+class converter {
+  public:
+    /// the type of operation used to convert a value
+    enum class kind : std::uint8_t {
+        linear,  //!< result = val*scale
+        affine,  //!< result = val*scale+offset
+        inverse,  //!< result = 1/(val*scale)
+        equation,  //!< conversion between equation units
+        invalid_conversion  //!< the units cannot be converted
+    };
+    /// Default constructor generating an invalid converter
+    // NOLINTNEXTLINE(modernize-use-equals-default)
+    converter() noexcept {}
+    /// Construct a converter from the start unit to the result unit
+    template<typename UX, typename UX2>
+    converter(const UX& start, const UX2& result)
+    {
+        static_assert(
+            std::is_same<UX, unit>::value ||
+                std::is_same<UX, precise_unit>::value,
+            "converter argument types must be unit or precise_unit");
+        static_assert(
+            std::is_same<UX2, unit>::value ||
+                std::is_same<UX2, precise_unit>::value,
+            "converter argument types must be unit or precise_unit");
+        classify(start, result);
+    }
+
+    /// Convert a value
+    double operator()(double val) const
+    {
+        switch (type_) {
+            case kind::linear:
+                return val * scale_;
+            case kind::affine:
+                return val * scale_ + offset_;
+            case kind::inverse:
+                return 1.0 / (val * scale_);
+            case kind::equation:
+                return convertEquation(val);
+            case kind::invalid_conversion:
+            default:
+                return constants::invalid_conversion;
+        }
+    }
+
+    /** Convert an array of values
+    @details input and output may be the same array to convert in place*/
+    void operator()(const double* input, double* output, std::size_t size)
+        const
+    {
+        switch (type_) {
+            case kind::linear:
+#ifdef UNITS_HEADER_ONLY
+                detail::scaleValues(input, output, size, scale_);
+#else
+                detail::convertLinearValues(input, output, size, scale_);
+#endif
+                break;
+            case kind::affine:
+#ifdef UNITS_HEADER_ONLY
+                detail::scaleOffsetValues(
+                    input, output, size, scale_, offset_);
+#else
+                detail::convertAffineValues(
+                    input, output, size, scale_, offset_);
+#endif
+                break;
+            case kind::inverse:
+#ifdef UNITS_HEADER_ONLY
+                detail::invertValues(input, output, size, scale_);
+#else
+                detail::convertInverseValues(input, output, size, scale_);
+#endif
+                break;
+            case kind::equation:
+                precise::equations::convert_equnit_to_values(
+                    input, output, size, start_base_);
+                for (std::size_t ii = 0; ii < size; ++ii) {
+                    output[ii] = output[ii] * scale_ / result_multiplier_;
+                }
+                precise::equations::convert_values_to_equnit(
+                    output, output, size, result_base_);
+                break;
+            case kind::invalid_conversion:
+            default:
+                std::fill(
+                    output, output + size, constants::invalid_conversion);
+                break;
+        }
+    }
+
+    /// get the kind of conversion
+    constexpr kind type() const { return type_; }
+    /// get the scale coefficient of the conversion
+    constexpr double scale() const { return scale_; }
+    /// get the offset coefficient of an affine conversion
+    constexpr double offset() const { return offset_; }
+    /// check if the converter can convert values
+    constexpr bool is_valid() const
+    {
+        return type_ != kind::invalid_conversion;
+    }
+
+  private:
+    template<typename UX, typename UX2>
+    void classify(const UX& start, const UX2& result)
+    {
+        if (start == result || is_default(start) || is_default(result)) {
+            setLinear(1.0);
+            return;
+        }
+        if ((start.has_e_flag() || result.has_e_flag()) &&
+            start.has_same_base(result.base_units())) {
+            if (is_temperature(start) || is_temperature(result)) {
+                setAffine(
+                    temperatureScale(start) / temperatureScale(result),
+                    detail::convertFlaggedUnits(0.0, start, result));
+                return;
+            }
+            if (start.has_same_base(precise::pressure::psi.base_units())) {
+                if (start.has_e_flag() == result.has_e_flag()) {
+                    setLinear(start.multiplier() / result.multiplier());
+                } else {
+                    setAffine(
+                        start.multiplier() / result.multiplier(),
+                        detail::convertFlaggedUnits(0.0, start, result));
+                }
+                return;
+            }
+        }
+        if (start.is_equation() || result.is_equation()) {
+            if (start.base_units().equivalent_non_counting(
+                    result.base_units())) {
+                type_ = kind::equation;
+                scale_ = start.multiplier();
+                result_multiplier_ = result.multiplier();
+                start_base_ = start.base_units();
+                result_base_ = result.base_units();
+            }
+            return;
+        }
+        if (start.is_per_unit() && result.is_per_unit() &&
+            unit_cast(start) != pu && unit_cast(result) != pu &&
+            start.base_units() != result.base_units()) {
+            // the known per unit conversions are either 1:1 or inverses
+            auto test = puconversion::knownConversions(
+                2.0, start.base_units(), result.base_units());
+            if (test == 0.5) {
+                type_ = kind::inverse;
+                scale_ = 1.0;
+                return;
+            }
+        }
+        auto base_start = start.base_units();
+        auto base_result = result.base_units();
+        if (start.is_per_unit() == result.is_per_unit() &&
+            !base_start.has_same_base(base_result) &&
+            base_start.has_same_base(base_result.inv()) &&
+            (!base_start.equivalent_non_counting(base_result) ||
+             std::isnan(detail::convertCountingUnits(1.0, start, result)))) {
+            type_ = kind::inverse;
+            scale_ = start.multiplier() * result.multiplier();
+            return;
+        }
+        // all the remaining conversions are a simple scaling
+        auto factor = convert(1.0, start, result);
+        if (!std::isnan(factor)) {
+            setLinear(factor);
+        }
+    }
+
+    void setLinear(double factor)
+    {
+        type_ = kind::linear;
+        scale_ = factor;
+    }
+    void setAffine(double factor, double bias)
+    {
+        type_ = kind::affine;
+        scale_ = factor;
+        offset_ = bias;
+    }
+
+    /// the scaling of a temperature unit relative to its absolute base
+    template<typename UX>
+    static double temperatureScale(const UX& temp)
+    {
+        return (is_temperature(temp) && degF == unit_cast(temp)) ?
+            5.0 / 9.0 :
+            temp.multiplier();
+    }
+
+    double convertEquation(double val) const
+    {
+        double keyval =
+            precise::equations::convert_equnit_to_value(val, start_base_);
+        keyval = keyval * scale_ / result_multiplier_;
+        return precise::equations::convert_value_to_equnit(
+            keyval, result_base_);
+    }
+
+    kind type_{kind::invalid_conversion};
+    double scale_{constants::invalid_conversion};
+    double offset_{0.0};
+    double result_multiplier_{1.0};
+    detail::unit_data start_base_{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    detail::unit_data result_base_{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+};
+
+/** Convert an array of values from one unit to another
+@param input pointer to the values to convert
+@param output pointer to the location to store the converted values,
+this may be the same as input
+@param size the number of values to convert
+*/
+template<typename UX, typename UX2>
+void convert(
+    const double* input,
+    double* output,
+    std::size_t size,
+    const UX& start,
+    const UX2& result)
+{
+    converter(start, result)(input, output, size);
+}
+
+/// Convert an array of values from one unit to another in place
+template<typename UX, typename UX2>
+void convert(
+    double* values,
+    std::size_t size,
+    const UX& start,
+    const UX2& result)
+{
+    converter(start, result)(values, values, size);
+}
+
 /// Class defining a measurement (value+unit)
 class measurement {
   public:
@@ -1884,7 +2189,19 @@ UNITS_EXPORT std::uint64_t setDefaultFlags(std::uint64_t defaultFlags);
 UNITS_EXPORT std::uint64_t getDefaultFlags();
 namespace detail {
     constexpr std::uint64_t minPartionSizeShift{37UL};
-}
+
+    /** classes of characters found in a unit string, used to skip string
+    cleaning phases when none of the characters they act on are present*/
+    enum unit_string_class : std::uint32_t {
+        non_ascii_chars = 1U,  //!< any byte >= 0x80
+        whitespace_chars = 2U,  //!< space, tab, newline, return or null
+        html_chars = 4U,  //!< '<' or '&'
+        bracket_chars = 8U,  //!< any of ()[]{}
+        digit_chars = 16U,  //!< 0-9
+        dot_chars = 32U,  //!< '.'
+        multiply_chars = 64U,  //!< '*'
+    };
+}  // namespace detail
 /** The unit conversion flag are some modifiers for the string conversion
 operations, some are used internally some are meant for external use, though all
 are possible to use externally
@@ -1934,7 +2251,10 @@ enum unit_conversion_flags : std::uint64_t {
     // nothing at 25, 24 through 26 are connected
     no_commodities = (1U << 26U),  //!< skip commodity checks
     no_default_units = (1U << 27U),  //!< skip any check of default unit types
-    // 28-31 are unused as of yet
+    /** don't store the names of unknown commodities for generating strings
+    later, useful for parsing untrusted input*/
+    no_commodity_interning = (1U << 28U),
+    // 29-31 are unused as of yet
     partition_check1 = (1ULL << 32U),  //!< counter for skipping partitioning
     // nothing at 28, 27 through 29 are connected to limit partition
     // depth
@@ -2028,6 +2348,92 @@ UNITS_EXPORT precise_measurement measurement_from_string(
     std::string measurement_string,
     std::uint64_t match_flags = getDefaultFlags());
 
+/** Generate precise_measurements from a batch of strings
+@details each distinct unit string in the batch is only parsed once, which is
+much faster than calling measurement_from_string on each string when the units
+repeat, as they do in a column of data
+@param measurement_strings pointer to the strings to convert
+@param size the number of strings to convert
+@param output pointer to the location to store the size measurements
+@param match_flags see / ref unit_conversion_flags to control the matching
+process somewhat
+@return a vector with an element for each string which is true if the
+measurement is valid, empty strings are not valid
+*/
+UNITS_EXPORT std::vector<bool> measurement_from_string(
+    const std::string* measurement_strings,
+    std::size_t size,
+    precise_measurement* output,
+    std::uint64_t match_flags = getDefaultFlags());
+
+/** Generate precise_measurements from a vector of strings
+@param measurement_strings the strings to convert
+@param output the vector to store the measurements in, it is resized to match
+@param match_flags see / ref unit_conversion_flags to control the matching
+process somewhat
+@return a vector with an element for each string which is true if the
+measurement is valid
+*/
+inline std::vector<bool> measurement_from_string(
+    const std::vector<std::string>& measurement_strings,
+    std::vector<precise_measurement>& output,
+    std::uint64_t match_flags = getDefaultFlags())
+{
+    output.resize(measurement_strings.size());
+    return measurement_from_string(
+        measurement_strings.data(),
+        measurement_strings.size(),
+        output.data(),
+        match_flags);
+}
+
+/** Generate precise_measurements from a batch of strings using multiple
+threads
+@details the strings are split into contiguous chunks which are each
+converted as a batch on a separate thread
+@param measurement_strings pointer to the strings to convert
+@param size the number of strings to convert
+@param thread_count the maximum number of threads to use, 0 to use the number
+of hardware threads
+@param output pointer to the location to store the size measurements
+@param match_flags see / ref unit_conversion_flags to control the matching
+process somewhat
+@return a vector with an element for each string which is true if the
+measurement is valid
+*/
+UNITS_EXPORT std::vector<bool> measurement_from_string(
+    const std::string* measurement_strings,
+    std::size_t size,
+    unsigned int thread_count,
+    precise_measurement* output,
+    std::uint64_t match_flags = getDefaultFlags());
+
+/** Generate precise_measurements from a vector of strings using multiple
+threads
+@param measurement_strings the strings to convert
+@param thread_count the maximum number of threads to use, 0 to use the number
+of hardware threads
+@param output the vector to store the measurements in, it is resized to match
+@param match_flags see / ref unit_conversion_flags to control the matching
+process somewhat
+@return a vector with an element for each string which is true if the
+measurement is valid
+*/
+inline std::vector<bool> measurement_from_string(
+    const std::vector<std::string>& measurement_strings,
+    unsigned int thread_count,
+    std::vector<precise_measurement>& output,
+    std::uint64_t match_flags = getDefaultFlags())
+{
+    output.resize(measurement_strings.size());
+    return measurement_from_string(
+        measurement_strings.data(),
+        measurement_strings.size(),
+        thread_count,
+        output.data(),
+        match_flags);
+}
+
 /** Generate a measurement from a string
 @param measurement_string the string to convert
 @param match_flags see / ref unit_conversion_flags to control the matching
@@ -2115,9 +2521,94 @@ UNITS_EXPORT void disableUserDefinedUnits();
 /// Enable the ability to add custom units for later access
 UNITS_EXPORT void enableUserDefinedUnits();
 
+namespace detail {
+    /** start reading the published snapshots of user defined units or
+    commodities on the current thread, reads may be nested and every call must
+    be matched by endSnapshotRead*/
+    UNITS_EXPORT void beginSnapshotRead() noexcept;
+    /// finish reading published snapshots
+    UNITS_EXPORT void endSnapshotRead() noexcept;
+    /** free a snapshot once no reader can be using it, the snapshot must
+    already be replaced in the pointer readers load it from*/
+    UNITS_EXPORT void retireSnapshot(void* object, void (*destroy)(void*));
+
+    /// scope guard for reading snapshots which may be retired by a writer
+    class snapshot_read_scope {
+      public:
+        snapshot_read_scope() noexcept { beginSnapshotRead(); }
+        /// a guard which only reads if reading is true
+        explicit snapshot_read_scope(bool reading) noexcept : reading_(reading)
+        {
+            if (reading_) {
+                beginSnapshotRead();
+            }
+        }
+        snapshot_read_scope(snapshot_read_scope&& other) noexcept :
+            reading_(other.reading_)
+        {
+            other.reading_ = false;
+        }
+        snapshot_read_scope& operator=(snapshot_read_scope&&) = delete;
+        snapshot_read_scope(const snapshot_read_scope&) = delete;
+        snapshot_read_scope& operator=(const snapshot_read_scope&) = delete;
+        ~snapshot_read_scope()
+        {
+            if (reading_) {
+                endSnapshotRead();
+            }
+        }
+
+      private:
+        bool reading_{true};
+    };
+}  // namespace detail
+
+/// usage statistics for one of the string caches
+struct cache_statistics {
+    std::uint64_t hits{0};  //!< the number of lookups found in the cache
+    std::uint64_t misses{0};  //!< the number of lookups not in the cache
+    std::size_t size{0};  //!< the current number of entries
+    std::size_t capacity{0};  //!< the maximum number of entries
+};
+
+/** Enable a cache of the results of unit_from_string
+@details the cache is keyed on the string, the match flags and the active
+units domain. It is cleared automatically if user defined units, custom
+commodities, the units domain, or the default flags are modified.
+@param capacity the maximum number of strings to keep in the cache
+*/
+UNITS_EXPORT void enableUnitStringCache(std::size_t capacity = 4096);
+/// Disable the unit string cache and release its memory
+UNITS_EXPORT void disableUnitStringCache();
+/// Remove all entries from the unit string cache and reset the statistics
+UNITS_EXPORT void clearUnitStringCache();
+/// Get the hit and miss statistics for the unit string cache
+UNITS_EXPORT cache_statistics getUnitStringCacheStatistics();
+
+/** Enable a cache of the strings generated by to_string for units
+@details the cache is keyed on the exact unit including the commodity and the
+match flags. It is cleared automatically if user defined units or custom
+commodities are modified.
+@param capacity the maximum number of units to keep in the cache
+*/
+UNITS_EXPORT void enableUnitOutputCache(std::size_t capacity = 4096);
+/// Disable the unit output cache and release its memory
+UNITS_EXPORT void disableUnitOutputCache();
+/// Remove all entries from the unit output cache and reset the statistics
+UNITS_EXPORT void clearUnitOutputCache();
+/// Get the hit and miss statistics for the unit output cache
+UNITS_EXPORT cache_statistics getUnitOutputCacheStatistics();
+
 /// get the code to use for a particular commodity
 UNITS_EXPORT std::uint32_t getCommodity(std::string comm);
 
+/** get the code to use for a particular commodity
+@details the names of commodities which are not known are stored so they can
+be used when generating strings unless the match_flags contain
+no_commodity_interning*/
+UNITS_EXPORT std::uint32_t
+    getCommodity(std::string comm, std::uint64_t match_flags);
+
 /// get the code to use for a particular commodity
 UNITS_EXPORT std::string getCommodityName(std::uint32_t commodity);
 
@@ -2130,6 +2621,130 @@ UNITS_EXPORT void disableCustomCommodities();
 /// Enable the ability to add custom commodities for later access
 UNITS_EXPORT void enableCustomCommodities();
 
+namespace detail {
+    struct parse_context_tables;
+    struct parse_context_cache;
+    struct parse_context_access;
+}  // namespace detail
+
+/** A set of settings for interpreting unit strings used in place of the
+process wide settings
+@details a context bundles a units domain, default match flags, user defined
+units, custom commodities, and an optional cache of parsed strings. The global
+user defined units, custom commodities, domain, and default flags are not used
+when parsing with a context, so any number of contexts can be used from
+different threads at the same time without modifying anything global. A
+context can be shared between threads but must not be modified while it is in
+use. Copies of a context share the same tables until one of them is modified.
+*/
+class UNITS_EXPORT parse_context {
+  public:
+    /// construct a context with the default domain and flags
+    parse_context();
+    /// construct a context for a units domain with a set of default flags
+    explicit parse_context(
+        std::uint64_t domain,
+        std::uint64_t default_flags = 0U);
+
+    /// get the units domain used when the flags don't specify one
+    std::uint64_t domain() const { return domain_; }
+    /// set the units domain, see /ref domains
+    void set_domain(std::uint64_t domain) { domain_ = domain; }
+    /// get the flags used when no flags are given
+    std::uint64_t flags() const { return flags_; }
+    /// set the flags used when no flags are given
+    void set_flags(std::uint64_t default_flags) { flags_ = default_flags; }
+
+    /// add a unit to be used for both string interpretation and generation
+    void add_unit(const std::string& name, const precise_unit& un);
+    /// add a unit only used in string interpretation
+    void add_input_unit(const std::string& name, const precise_unit& un);
+    /// add a unit only used in string generation
+    void add_output_unit(const std::string& name, const precise_unit& un);
+    /// remove a unit from both string interpretation and generation
+    void remove_unit(const std::string& name);
+    /// remove all the units from the context
+    void clear_units();
+
+    /// add a commodity name and code
+    void add_commodity(std::string comm, std::uint32_t code);
+    /// remove all the commodities from the context
+    void clear_commodities();
+
+    /** enable a cache of the results of parsing strings with the context
+    @details the cache is shared by copies of the context until one of them
+    is modified*/
+    void enable_cache(std::size_t capacity = 4096);
+    /// disable the cache and release its memory
+    void disable_cache();
+    /// get the hit and miss statistics for the cache
+    cache_statistics get_cache_statistics() const;
+
+  private:
+    friend struct detail::parse_context_access;
+    /// replace the tables and any cache results generated from the old ones
+    void replace_tables(std::shared_ptr<const detail::parse_context_tables>);
+
+    std::uint64_t domain_;
+    std::uint64_t flags_;
+    std::shared_ptr<const detail::parse_context_tables> tables_;
+    std::shared_ptr<detail::parse_context_cache> cache_;
+};
+
+/** Generate a precise unit object from a string using the settings in a
+parse_context
+@param context the context containing the domain, units, and commodities
+@param unit_string the string to convert
+@param match_flags see /ref unit_conversion_flags to control the matching
+process somewhat
+@return a precise unit corresponding to the string if no match was found the
+unit will be an error unit
+*/
+UNITS_EXPORT precise_unit unit_from_string(
+    const parse_context& context,
+    std::string unit_string,
+    std::uint64_t match_flags);
+
+/** Generate a precise unit object from a string using the settings and
+default flags in a parse_context*/
+inline precise_unit
+    unit_from_string(const parse_context& context, std::string unit_string)
+{
+    return unit_from_string(context, std::move(unit_string), context.flags());
+}
+
+/** Generate a precise_measurement from a string using the settings in a
+parse_context*/
+UNITS_EXPORT precise_measurement measurement_from_string(
+    const parse_context& context,
+    std::string measurement_string,
+    std::uint64_t match_flags);
+
+/** Generate a precise_measurement from a string using the settings and
+default flags in a parse_context*/
+inline precise_measurement measurement_from_string(
+    const parse_context& context,
+    std::string measurement_string)
+{
+    return measurement_from_string(
+        context, std::move(measurement_string), context.flags());
+}
+
+/// Generate a string representation of a unit using the units and
+/// commodities in a parse_context
+UNITS_EXPORT std::string to_string(
+    const parse_context& context,
+    const precise_unit& units,
+    std::uint64_t match_flags);
+
+/// Generate a string representation of a unit using the settings and default
+/// flags in a parse_context
+inline std::string
+    to_string(const parse_context& context, const precise_unit& units)
+{
+    return to_string(context, units, context.flags());
+}
+
 // Some specific unit code standards
 #ifndef UNITS_DISABLE_EXTRA_UNIT_STANDARDS
 /// generate a unit from a string as defined by the X12 standard
@@ -2318,6 +2933,17 @@ namespace detail {
         std::string
             testCleanUpString(std::string testString, std::uint32_t commodity);
 
+        // get the unit_string_class bits for a string
+        std::uint32_t testClassifyUnitString(const std::string& unit_string);
+
+        // look up a string in the table of units specific to a domain
+        precise_unit testDomainUnit(
+            std::uint64_t domain,
+            const std::string& unit_string);
+        // get the strings in the table of units specific to a domain in
+        // table order
+        std::vector<std::string> testDomainUnitNames(std::uint64_t domain);
+
         // test the add unit power operations
         void testAddUnitPower(
             std::string& str,
@@ -2333,6 +2959,9 @@ namespace detail {
     UNITS_EXPORT const std::unordered_map<std::string, precise_unit>&
         getUnitStringMap();
     UNITS_EXPORT const std::unordered_map<unit, const char*>& getUnitNameMap();
+    // direct lookup in the table of defined unit strings
+    UNITS_EXPORT const precise_unit*
+        lookupUnitString(const char* str, std::size_t length);
 
 #ifndef UNITS_DISABLE_EXTRA_UNIT_STANDARDS
     // get the raw array for testing the r20 database
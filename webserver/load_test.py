@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+# Copyright (c) 2019-2025,
+# Lawrence Livermore National Security, LLC;
+# See the top-level NOTICE for additional details. All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+"""Local load test of the units webserver.
+
+Starts the webserver once for each thread count, sends conversion requests
+from a number of concurrent clients and reports the p50 and p99 latency.  A
+fraction of the requests use the slow fuzz inputs from test/files/fuzz_issues
+to show how slow parses affect the other requests.
+
+Example:
+    python3 load_test.py --server ../build/bin/units_webserver --threads 1 2 4
+"""
+
+import argparse
+import glob
+import http.client
+import os
+import random
+import subprocess
+import threading
+import time
+import urllib.parse
+
+FAST_REQUESTS = [
+    ("10 ft", "m"),
+    ("3 kg", "lb"),
+    ("45 mph", "m/s"),
+    ("12 kWh", "J"),
+    ("2.5 gal", "L"),
+    ("100 degF", "degC"),
+]
+
+
+def load_slow_strings(folder):
+    strings = []
+    for name in sorted(glob.glob(os.path.join(folder, "slow*"))):
+        with open(name, "rb") as sfile:
+            data = sfile.read()
+        if len(data) <= 256:
+            strings.append(data.decode("latin-1"))
+    return strings
+
+
+ENDPOINTS = {
+    "trivial": "/convert_trivial?",
+    "json": "/convert_json?",
+    "html": "/convert?",
+}
+
+
+def make_target(measurement, units, output="trivial"):
+    query = urllib.parse.urlencode({"measurement": measurement, "units": units})
+    return ENDPOINTS[output] + query
+
+
+def wait_for_server(port, timeout=10.0):
+    stop = time.time() + timeout
+    while time.time() < stop:
+        try:
+            conn = http.client.HTTPConnection("127.0.0.1", port, timeout=1)
+            conn.request("HEAD", "/")
+            conn.getresponse().read()
+            conn.close()
+            return True
+        except OSError:
+            time.sleep(0.1)
+    return False
+
+
+def run_client(port, targets, latencies, statuses):
+    conn = http.client.HTTPConnection("127.0.0.1", port, timeout=60)
+    for target in targets:
+        start = time.perf_counter()
+        try:
+            conn.request("GET", target)
+            res = conn.getresponse()
+            res.read()
+            statuses.append(res.status)
+        except (OSError, http.client.HTTPException):
+            statuses.append(0)
+            conn.close()
+            conn = http.client.HTTPConnection("127.0.0.1", port, timeout=60)
+        latencies.append(time.perf_counter() - start)
+    conn.close()
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    if not ordered:
+        return float("nan")
+    index = min(len(ordered) - 1, int(fraction * len(ordered)))
+    return ordered[index]
+
+
+def run_load(args, threads, slow_strings):
+    port = args.port
+    server = subprocess.Popen(
+        [
+            args.server,
+            "127.0.0.1",
+            str(port),
+            "--threads",
+            str(threads),
+            "--compute-threads",
+            str(args.compute_threads or threads),
+            "--response-cache",
+            str(args.response_cache),
+        ],
+        stdout=subprocess.DEVNULL,
+        stderr=subprocess.DEVNULL,
+    )
+    try:
+        if not wait_for_server(port):
+            raise RuntimeError("the webserver did not start")
+        rng = random.Random(threads)
+        client_targets = []
+        for _ in range(args.clients):
+            targets = []
+            for _ in range(args.requests // args.clients):
+                if slow_strings and rng.random() < args.slow_fraction:
+                    targets.append(
+                        make_target(rng.choice(slow_strings), "m", args.format)
+                    )
+                else:
+                    targets.append(
+                        make_target(*rng.choice(FAST_REQUESTS), args.format)
+                    )
+            client_targets.append(targets)
+        latencies = []
+        statuses = []
+        clients = [
+            threading.Thread(
+                target=run_client, args=(port, targets, latencies, statuses)
+            )
+            for targets in client_targets
+        ]
+        start = time.perf_counter()
+        for client in clients:
+            client.start()
+        for client in clients:
+            client.join()
+        elapsed = time.perf_counter() - start
+    finally:
+        server.terminate()
+        server.wait()
+    return {
+        "threads": threads,
+        "requests": len(latencies),
+        # some of the fuzz inputs are rejected with a bad request
+        "errors": sum(1 for status in statuses if status not in (200, 400)),
+        "rate": len(latencies) / elapsed,
+        "p50": percentile(latencies, 0.50) * 1000.0,
+        "p99": percentile(latencies, 0.99) * 1000.0,
+    }
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--server", default="./units_webserver")
+    parser.add_argument("--port", type=int, default=18080)
+    parser.add_argument("--threads", type=int, nargs="+", default=[1, 2, 4, 8])
+    parser.add_argument(
+        "--compute-threads",
+        type=int,
+        default=0,
+        help="threads in the compute pool, defaults to the io thread count",
+    )
+    parser.add_argument(
+        "--response-cache",
+        type=int,
+        default=4096,
+        help="entries in the server response cache, 0 to disable it",
+    )
+    parser.add_argument(
+        "--format",
+        choices=sorted(ENDPOINTS),
+        default="trivial",
+        help="the format of the conversion responses",
+    )
+    parser.add_argument("--clients", type=int, default=16)
+    parser.add_argument("--requests", type=int, default=4000)
+    parser.add_argument("--slow-fraction", type=float, default=0.02)
+    parser.add_argument(
+        "--slow-folder",
+        default=os.path.join(here, "..", "test", "files", "fuzz_issues"),
+    )
+    args = parser.parse_args()
+
+    slow_strings = load_slow_strings(args.slow_folder)
+    print(
+        "{:>8} {:>9} {:>7} {:>10} {:>9} {:>9}".format(
+            "threads", "requests", "errors", "req/s", "p50(ms)", "p99(ms)"
+        )
+    )
+    for threads in args.threads:
+        result = run_load(args, threads, slow_strings)
+        print(
+            "{threads:>8} {requests:>9} {errors:>7} {rate:>10.1f} "
+            "{p50:>9.2f} {p99:>9.2f}".format(**result)
+        )
+
+
+if __name__ == "__main__":
+    main()
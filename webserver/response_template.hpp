@@ -0,0 +1,85 @@
+/*
+Copyright (c) 2019-2025,
+Lawrence Livermore National Security, LLC;
+See the top-level NOTICE for additional details. All rights reserved.
+SPDX-License-Identifier: BSD-3-Clause
+*/
+#pragma once
+
+#include <array>
+#include <boost/beast/core/string.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// the values which can be placed in a response template
+enum template_slot : std::size_t {
+    m1_slot,  // $M1$ the requested measurement
+    u1_slot,  // $U1$ the requested units
+    value_slot,  // $VALUE$ the converted value
+    m2_slot,  // $M2$ the measurement as interpreted
+    u2_slot,  // $U2$ the units as interpreted
+    slot_count
+};
+
+// A response page split into literal text and the slots for the values.  The
+// template is split once when it is loaded, so a response is assembled with a
+// single allocation instead of searching the page for each token.
+class response_template {
+  public:
+    explicit response_template(const std::string& text)
+    {
+        static const std::array<const char*, slot_count> tokens{
+            {"$M1$", "$U1$", "$VALUE$", "$M2$", "$U2$"}};
+        std::size_t start{0};
+        std::size_t loc = text.find('$');
+        while (loc != std::string::npos) {
+            std::size_t slot{0};
+            while (slot < slot_count &&
+                   text.compare(
+                       loc, std::char_traits<char>::length(tokens[slot]),
+                       tokens[slot]) != 0) {
+                ++slot;
+            }
+            if (slot == slot_count) {
+                loc = text.find('$', loc + 1);
+                continue;
+            }
+            segments_.push_back({text.substr(start, loc - start), slot});
+            start = loc + std::char_traits<char>::length(tokens[slot]);
+            loc = text.find('$', start);
+        }
+        segments_.push_back({text.substr(start), slot_count});
+    }
+
+    // assemble a response from the values for each slot
+    std::string render(
+        const std::array<boost::beast::string_view, slot_count>& values) const
+    {
+        std::size_t size{0};
+        for (const auto& seg : segments_) {
+            size += seg.literal.size();
+            if (seg.slot < slot_count) {
+                size += values[seg.slot].size();
+            }
+        }
+        std::string page;
+        page.reserve(size);
+        for (const auto& seg : segments_) {
+            page.append(seg.literal);
+            if (seg.slot < slot_count) {
+                page.append(values[seg.slot].data(), values[seg.slot].size());
+            }
+        }
+        return page;
+    }
+
+  private:
+    struct segment {
+        // the text before the slot
+        std::string literal;
+        // the slot following the text, slot_count for the final text
+        std::size_t slot;
+    };
+    std::vector<segment> segments_;
+};
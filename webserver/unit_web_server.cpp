@@ -19,27 +19,36 @@ SPDX-License-Identifier: BSD-3-Clause
 //------------------------------------------------------------------------------
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/beast/version.hpp>
 #include <boost/config.hpp>
 #include <boost/container/flat_map.hpp>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <streambuf>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "response_template.hpp"
 #include "units/units.hpp"
 
 namespace beast = boost::beast;  // from <boost/beast.hpp>
@@ -65,6 +74,386 @@ static std::atomic<int> success_count{0};
 static std::atomic<int> fail_count{0};
 static std::atomic<int> request_count{0};
 static std::atomic<int> bad_request_count{0};
+static std::atomic<int> busy_count{0};
+// requests which have been read but not yet responded to
+static std::atomic<int> in_flight_requests{0};
+// conversions waiting for a compute thread
+static std::atomic<int> queued_conversions{0};
+
+// the endpoints with separate request counts
+enum endpoint : std::size_t {
+    index_endpoint,
+    convert_endpoint,
+    convert_json_endpoint,
+    convert_trivial_endpoint,
+    convert_batch_endpoint,
+    metrics_endpoint,
+    other_endpoint,
+    endpoint_count
+};
+static const std::array<const char*, endpoint_count> endpoint_names{
+    {"index",
+     "convert",
+     "convert_json",
+     "convert_trivial",
+     "convert_batch",
+     "metrics",
+     "other"}};
+static std::array<std::atomic<std::uint64_t>, endpoint_count>
+    endpoint_requests{};
+
+// the phases of a conversion with latency histograms
+enum phase : std::size_t {
+    parse_phase,
+    convert_phase,
+    format_phase,
+    phase_count
+};
+static const std::array<const char*, phase_count> phase_names{
+    {"parse", "convert", "format"}};
+
+// Latency histograms for the phases of a conversion.  Each thread records into
+// its own buckets so recording is a few uncontended relaxed atomic adds, the
+// buckets of all the threads are summed when the metrics are requested.
+class latency_histograms {
+  public:
+    void record(phase stage, std::chrono::steady_clock::duration duration)
+    {
+        auto nanoseconds = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+                .count());
+        std::size_t bucket{0};
+        while (bucket < bounds.size() && nanoseconds > bounds[bucket]) {
+            ++bucket;
+        }
+        auto& local = thread_buckets();
+        local.counts[stage][bucket].fetch_add(1, std::memory_order_relaxed);
+        local.sums[stage].fetch_add(nanoseconds, std::memory_order_relaxed);
+    }
+
+    // write the histograms in the Prometheus text format
+    void write(std::ostream& out)
+    {
+        out << "# HELP units_phase_duration_seconds time spent in each phase "
+               "of a conversion request\n"
+            << "# TYPE units_phase_duration_seconds histogram\n";
+        std::lock_guard<std::mutex> lock(threads_lock_);
+        for (std::size_t stage = 0; stage < phase_count; ++stage) {
+            std::uint64_t total{0};
+            std::uint64_t sum{0};
+            for (std::size_t bucket = 0; bucket <= bounds.size(); ++bucket) {
+                for (const auto& local : threads_) {
+                    total += local->counts[stage][bucket].load(
+                        std::memory_order_relaxed);
+                }
+                out << "units_phase_duration_seconds_bucket{phase=\""
+                    << phase_names[stage] << "\",le=\"";
+                if (bucket < bounds.size()) {
+                    out << static_cast<double>(bounds[bucket]) * 1e-9;
+                } else {
+                    out << "+Inf";
+                }
+                out << "\"} " << total << '\n';
+            }
+            for (const auto& local : threads_) {
+                sum += local->sums[stage].load(std::memory_order_relaxed);
+            }
+            out << "units_phase_duration_seconds_sum{phase=\""
+                << phase_names[stage] << "\"} "
+                << static_cast<double>(sum) * 1e-9 << '\n'
+                << "units_phase_duration_seconds_count{phase=\""
+                << phase_names[stage] << "\"} " << total << '\n';
+        }
+    }
+
+  private:
+    // upper bounds of the buckets in nanoseconds
+    static constexpr std::array<std::uint64_t, 14> bounds{
+        {5000ULL,
+         10000ULL,
+         25000ULL,
+         50000ULL,
+         100000ULL,
+         250000ULL,
+         500000ULL,
+         1000000ULL,
+         2500000ULL,
+         5000000ULL,
+         10000000ULL,
+         25000000ULL,
+         100000000ULL,
+         1000000000ULL}};
+
+    struct buckets {
+        std::array<
+            std::array<std::atomic<std::uint64_t>, bounds.size() + 1>,
+            phase_count>
+            counts{};
+        std::array<std::atomic<std::uint64_t>, phase_count> sums{};
+    };
+
+    // get the buckets of the calling thread, they are registered on the
+    // first use and live as long as the histograms
+    buckets& thread_buckets()
+    {
+        thread_local buckets* local{nullptr};
+        if (local == nullptr) {
+            std::lock_guard<std::mutex> lock(threads_lock_);
+            threads_.push_back(std::make_unique<buckets>());
+            local = threads_.back().get();
+        }
+        return *local;
+    }
+
+    std::mutex threads_lock_;
+    std::vector<std::unique_ptr<buckets>> threads_;
+};
+constexpr std::array<std::uint64_t, 14> latency_histograms::bounds;
+
+static latency_histograms phase_latency;
+
+// measure the time spent in a phase of a conversion
+class phase_timer {
+  public:
+    explicit phase_timer(phase stage) :
+        stage_(stage), start_(std::chrono::steady_clock::now())
+    {
+    }
+    ~phase_timer()
+    {
+        phase_latency.record(stage_, std::chrono::steady_clock::now() - start_);
+    }
+    phase_timer(const phase_timer&) = delete;
+    phase_timer& operator=(const phase_timer&) = delete;
+
+  private:
+    phase stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// a conversion response which can be reused for identical requests
+struct cached_response {
+    std::string body;
+    std::string etag;
+    const char* content_type;
+    bool valid;
+};
+
+// Size bounded cache of the conversion responses keyed on the normalized
+// request parameters and the output format.  The entries are split over a
+// number of independently locked shards which are each kept in least recently
+// used order.
+class response_cache {
+  public:
+    // set the maximum number of entries, 0 disables the cache, only called
+    // before the server starts.  The entries are split over the shards so the
+    // total matches the capacity, a capacity below the shard count leaves some
+    // shards without entries.
+    void set_capacity(std::size_t capacity)
+    {
+        capacity_ = capacity;
+        for (std::size_t ii = 0; ii < shard_count; ++ii) {
+            shards_[ii].capacity = capacity / shard_count +
+                ((ii < capacity % shard_count) ? 1U : 0U);
+        }
+    }
+    bool enabled() const { return capacity_ > 0; }
+
+    std::shared_ptr<const cached_response> find(const std::string& key)
+    {
+        auto& shard = get_shard(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto fnd = shard.index.find(key);
+        if (fnd == shard.index.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        shard.entries.splice(
+            shard.entries.begin(), shard.entries, fnd->second);
+        return fnd->second->second;
+    }
+
+    void insert(
+        const std::string& key,
+        std::shared_ptr<const cached_response> response)
+    {
+        auto& shard = get_shard(key);
+        if (shard.capacity == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto fnd = shard.index.find(key);
+        if (fnd != shard.index.end()) {
+            fnd->second->second = std::move(response);
+            shard.entries.splice(
+                shard.entries.begin(), shard.entries, fnd->second);
+            return;
+        }
+        shard.entries.emplace_front(key, std::move(response));
+        shard.index.emplace(key, shard.entries.begin());
+        if (shard.index.size() > shard.capacity) {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+    }
+
+    units::cache_statistics statistics()
+    {
+        units::cache_statistics stats;
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.capacity = capacity_;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            stats.size += shard.index.size();
+        }
+        return stats;
+    }
+
+  private:
+    static constexpr std::size_t shard_count{16};
+    using entry =
+        std::pair<std::string, std::shared_ptr<const cached_response>>;
+    struct cache_shard {
+        std::mutex lock;
+        std::size_t capacity{0};
+        std::list<entry> entries;
+        std::unordered_map<std::string, std::list<entry>::iterator> index;
+    };
+
+    cache_shard& get_shard(const std::string& key)
+    {
+        return shards_[std::hash<std::string>{}(key) % shard_count];
+    }
+
+    std::array<cache_shard, shard_count> shards_;
+    std::size_t capacity_{0};
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+};
+
+static response_cache conversion_cache;
+
+// generate a strong entity tag from the content of a response
+static std::string make_etag(const std::string& body)
+{
+    // 64 bit FNV-1a hash
+    std::uint64_t hash{0xcbf29ce484222325ULL};
+    for (auto cc : body) {
+        hash ^= static_cast<unsigned char>(cc);
+        hash *= 0x100000001b3ULL;
+    }
+    static constexpr const char* digits = "0123456789abcdef";
+    std::string etag(18, '"');
+    for (int ii = 16; ii > 0; --ii) {
+        etag[ii] = digits[hash & 0xFU];
+        hash >>= 4U;
+    }
+    return etag;
+}
+
+// check if an If-None-Match header matches an entity tag, the comparison is
+// weak so a W/ prefix on the tags in the header is ignored
+static bool
+    etag_matches(beast::string_view if_none_match, const std::string& etag)
+{
+    return if_none_match == "*" ||
+        if_none_match.find(etag) != beast::string_view::npos;
+}
+
+// write one metric family for each of the caches
+template<typename Value>
+static void write_cache_metric(
+    std::ostream& out,
+    const char* name,
+    const char* type,
+    const char* help,
+    Value value)
+{
+    static const std::array<const char*, 3> caches{
+        {"unit_string", "unit_output", "response"}};
+    const std::array<units::cache_statistics, 3> stats{
+        {units::getUnitStringCacheStatistics(),
+         units::getUnitOutputCacheStatistics(),
+         conversion_cache.statistics()}};
+    out << "# HELP " << name << ' ' << help << '\n'
+        << "# TYPE " << name << ' ' << type << '\n';
+    for (std::size_t ii = 0; ii < caches.size(); ++ii) {
+        out << name << "{cache=\"" << caches[ii] << "\"} " << value(stats[ii])
+            << '\n';
+    }
+}
+
+// generate the metrics in the Prometheus text format
+static std::string generate_metrics()
+{
+    std::ostringstream out;
+    out << "# HELP units_requests_total requests received by endpoint\n"
+        << "# TYPE units_requests_total counter\n";
+    for (std::size_t ii = 0; ii < endpoint_count; ++ii) {
+        out << "units_requests_total{endpoint=\"" << endpoint_names[ii]
+            << "\"} " << endpoint_requests[ii].load() << '\n';
+    }
+    out << "# HELP units_bad_requests_total requests which were rejected\n"
+        << "# TYPE units_bad_requests_total counter\n"
+        << "units_bad_requests_total " << bad_request_count.load() << '\n'
+        << "# HELP units_busy_responses_total conversions turned away "
+           "because the compute pool was full\n"
+        << "# TYPE units_busy_responses_total counter\n"
+        << "units_busy_responses_total " << busy_count.load() << '\n'
+        << "# HELP units_conversions_total conversions by result\n"
+        << "# TYPE units_conversions_total counter\n"
+        << "units_conversions_total{result=\"success\"} "
+        << success_count.load() << '\n'
+        << "units_conversions_total{result=\"fail\"} " << fail_count.load()
+        << '\n'
+        << "# HELP units_in_flight_requests requests being processed\n"
+        << "# TYPE units_in_flight_requests gauge\n"
+        << "units_in_flight_requests " << in_flight_requests.load() << '\n'
+        << "# HELP units_queued_conversions conversions waiting for a "
+           "compute thread\n"
+        << "# TYPE units_queued_conversions gauge\n"
+        << "units_queued_conversions " << queued_conversions.load() << '\n';
+    phase_latency.write(out);
+    using stats = units::cache_statistics;
+    write_cache_metric(
+        out,
+        "units_cache_hits_total",
+        "counter",
+        "hits in the unit and response caches",
+        [](const stats& cache) { return cache.hits; });
+    write_cache_metric(
+        out,
+        "units_cache_misses_total",
+        "counter",
+        "misses in the unit and response caches",
+        [](const stats& cache) { return cache.misses; });
+    write_cache_metric(
+        out,
+        "units_cache_hit_ratio",
+        "gauge",
+        "fraction of the cache lookups which were hits",
+        [](const stats& cache) {
+            auto lookups = cache.hits + cache.misses;
+            return (lookups > 0) ? static_cast<double>(cache.hits) /
+                    static_cast<double>(lookups) :
+                                   0.0;
+        });
+    write_cache_metric(
+        out,
+        "units_cache_entries",
+        "gauge",
+        "entries in the unit and response caches",
+        [](const stats& cache) { return cache.size; });
+    write_cache_metric(
+        out,
+        "units_cache_capacity",
+        "gauge",
+        "maximum entries in the unit and response caches",
+        [](const stats& cache) { return cache.capacity; });
+    return out.str();
+}
 
 // decode a URI to clean up a string, convert character codes in a uri to the
 // original character
@@ -94,27 +483,6 @@ static std::string uri_decode(beast::string_view str)
     return ret;
 }
 
-static void string_substitution_single(
-    std::string& page,
-    const std::string& search,
-    const std::string& rep)
-{
-    auto v = page.find(search);
-    while (v != std::string::npos) {
-        page.replace(v, search.size(), rep);
-        v = page.find(search);
-    }
-}
-
-static void string_substitution(
-    std::string& page,
-    const std::vector<std::pair<std::string, std::string>>& subs)
-{
-    for (const auto& sub_pair : subs) {
-        string_substitution_single(page, sub_pair.first, sub_pair.second);
-    }
-}
-
 // function to extract the request parameters and clean up the target
 static std::pair<
     beast::string_view,
@@ -171,18 +539,465 @@ static std::pair<
     return results;
 }
 
+// the parameters of a single conversion request
+struct conversion_request {
+    // the output format, convert, convert_json, or convert_trivial
+    std::string format;
+    std::string measurement;
+    std::string units;
+    bool to_string{false};
+    bool reset{false};
+    // the reason the request is invalid, empty for a valid request
+    std::string error;
+};
+
+// remove leading and trailing whitespace
+static std::string trim_whitespace(const std::string& str)
+{
+    static const char* whitespace = " \t\r\n";
+    auto start = str.find_first_not_of(whitespace);
+    if (start == std::string::npos) {
+        return std::string{};
+    }
+    auto stop = str.find_last_not_of(whitespace);
+    return str.substr(start, stop - start + 1);
+}
+
+// read and normalize the parameters of a conversion request
+static conversion_request
+    read_conversion_request(beast::string_view target, beast::string_view body)
+{
+    conversion_request conv;
+    auto reqpr = process_request_parameters(target, body);
+    if (reqpr.first == "convert" || reqpr.first == "convert_json") {
+        conv.format = std::string(reqpr.first);
+    } else {
+        conv.format = "convert_trivial";
+    }
+    auto& fields = reqpr.second;
+    if (fields.find("measurement") != fields.end()) {
+        conv.measurement = trim_whitespace(fields["measurement"]);
+        if (conv.measurement.size() > 256) {
+            conv.error =
+                "measurement string size exceeds limits of 256 characters";
+            return conv;
+        }
+    }
+    if (fields.find("units") != fields.end()) {
+        conv.units = trim_whitespace(fields["units"]);
+        if (conv.units.size() > 256) {
+            conv.error =
+                "conversion units string size greater than 256 characters";
+            return conv;
+        }
+    }
+    if (fields.find("caction") != fields.end()) {
+        if (fields["caction"] == "to_string") {
+            conv.to_string = true;
+        } else if (fields["caction"] == "reset") {
+            conv.reset = true;
+        }
+    }
+    return conv;
+}
+
+// the key of a conversion request in the response cache
+static std::string response_key(const conversion_request& conv)
+{
+    std::string key;
+    key.reserve(
+        conv.format.size() + conv.measurement.size() + conv.units.size() + 4);
+    key.append(conv.format);
+    key.push_back(conv.to_string ? '+' : '-');
+    key.append(conv.measurement);
+    key.push_back('\0');
+    key.append(conv.units);
+    return key;
+}
+
+// count a conversion request in the endpoint metrics
+static void count_conversion(const conversion_request& conv)
+{
+    if (conv.format == "convert") {
+        ++endpoint_requests[convert_endpoint];
+    } else if (conv.format == "convert_json") {
+        ++endpoint_requests[convert_json_endpoint];
+    } else {
+        ++endpoint_requests[convert_trivial_endpoint];
+    }
+}
+
+// the maximum number of conversions in a single batch request
+static constexpr std::size_t max_batch_size{4096};
+
+// skip whitespace in a JSON string
+static void skip_json_whitespace(beast::string_view json, std::size_t& pos)
+{
+    while (pos < json.size() &&
+           (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\n' ||
+            json[pos] == '\r')) {
+        ++pos;
+    }
+}
+
+// append a unicode code point to a string as UTF-8
+static void append_utf8(std::string& str, unsigned int code)
+{
+    if (code < 0x80U) {
+        str.push_back(static_cast<char>(code));
+    } else if (code < 0x800U) {
+        str.push_back(static_cast<char>(0xC0U | (code >> 6U)));
+        str.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+    } else if (code < 0x10000U) {
+        str.push_back(static_cast<char>(0xE0U | (code >> 12U)));
+        str.push_back(static_cast<char>(0x80U | ((code >> 6U) & 0x3FU)));
+        str.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+    } else {
+        str.push_back(static_cast<char>(0xF0U | (code >> 18U)));
+        str.push_back(static_cast<char>(0x80U | ((code >> 12U) & 0x3FU)));
+        str.push_back(static_cast<char>(0x80U | ((code >> 6U) & 0x3FU)));
+        str.push_back(static_cast<char>(0x80U | (code & 0x3FU)));
+    }
+}
+
+// read the 4 hex digits of a \u escape sequence
+static bool read_json_hex(
+    beast::string_view json,
+    std::size_t& pos,
+    unsigned int& code)
+{
+    if (pos + 4 > json.size()) {
+        return false;
+    }
+    code = 0;
+    for (std::size_t ii = 0; ii < 4; ++ii) {
+        auto c = json[pos++];
+        code <<= 4U;
+        if (c >= '0' && c <= '9') {
+            code += static_cast<unsigned int>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            code += static_cast<unsigned int>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            code += static_cast<unsigned int>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// read a JSON string starting at the opening quote
+static bool read_json_string(
+    beast::string_view json,
+    std::size_t& pos,
+    std::string& str)
+{
+    if (pos >= json.size() || json[pos] != '"') {
+        return false;
+    }
+    ++pos;
+    str.clear();
+    while (pos < json.size()) {
+        auto c = json[pos++];
+        if (c == '"') {
+            return true;
+        }
+        if (c != '\\') {
+            str.push_back(c);
+            continue;
+        }
+        if (pos >= json.size()) {
+            return false;
+        }
+        c = json[pos++];
+        switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                str.push_back(c);
+                break;
+            case 'b':
+                str.push_back('\b');
+                break;
+            case 'f':
+                str.push_back('\f');
+                break;
+            case 'n':
+                str.push_back('\n');
+                break;
+            case 'r':
+                str.push_back('\r');
+                break;
+            case 't':
+                str.push_back('\t');
+                break;
+            case 'u': {
+                unsigned int code{0};
+                if (!read_json_hex(json, pos, code)) {
+                    return false;
+                }
+                // a low surrogate can only follow a high surrogate
+                if (code >= 0xDC00U && code < 0xE000U) {
+                    return false;
+                }
+                // combine a surrogate pair, an unpaired high surrogate can't
+                // be encoded as valid UTF-8
+                if (code >= 0xD800U && code < 0xDC00U) {
+                    if (json.substr(pos, 2) != "\\u") {
+                        return false;
+                    }
+                    pos += 2;
+                    unsigned int low{0};
+                    if (!read_json_hex(json, pos, low) || low < 0xDC00U ||
+                        low >= 0xE000U) {
+                        return false;
+                    }
+                    code = 0x10000U + ((code - 0xD800U) << 10U) +
+                        (low - 0xDC00U);
+                }
+                append_utf8(str, code);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+// escape a string for use in a JSON document
+static std::string json_escape(const std::string& str)
+{
+    std::string ret;
+    ret.reserve(str.size());
+    for (auto c : str) {
+        switch (c) {
+            case '"':
+                ret.append("\\\"");
+                break;
+            case '\\':
+                ret.append("\\\\");
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20U) {
+                    std::ostringstream code;
+                    code << "\\u" << std::hex << std::setw(4)
+                         << std::setfill('0') << static_cast<int>(c);
+                    ret.append(code.str());
+                } else {
+                    ret.push_back(c);
+                }
+                break;
+        }
+    }
+    return ret;
+}
+
+// a single conversion in a batch request
+struct batch_item {
+    std::string measurement;
+    std::string units;
+};
+
+// read a JSON array of {"measurement":"...","units":"..."} objects, returns
+// an empty string on success or a description of the problem
+static std::string
+    read_batch_request(beast::string_view json, std::vector<batch_item>& items)
+{
+    std::size_t pos{0};
+    skip_json_whitespace(json, pos);
+    if (pos >= json.size() || json[pos] != '[') {
+        return "convert_batch requires a JSON array";
+    }
+    ++pos;
+    skip_json_whitespace(json, pos);
+    if (pos < json.size() && json[pos] == ']') {
+        ++pos;
+    } else {
+        while (true) {
+            if (pos >= json.size() || json[pos] != '{') {
+                return "convert_batch array elements must be objects";
+            }
+            ++pos;
+            batch_item item;
+            skip_json_whitespace(json, pos);
+            if (pos < json.size() && json[pos] == '}') {
+                ++pos;
+            } else {
+                while (true) {
+                    std::string key;
+                    std::string value;
+                    skip_json_whitespace(json, pos);
+                    if (!read_json_string(json, pos, key)) {
+                        return "invalid object key in convert_batch";
+                    }
+                    skip_json_whitespace(json, pos);
+                    if (pos >= json.size() || json[pos] != ':') {
+                        return "missing ':' in convert_batch object";
+                    }
+                    ++pos;
+                    skip_json_whitespace(json, pos);
+                    if (!read_json_string(json, pos, value)) {
+                        return "convert_batch values must be valid strings";
+                    }
+                    if (value.size() > 256) {
+                        return "string size exceeds limits of 256 characters";
+                    }
+                    if (key == "measurement") {
+                        item.measurement = std::move(value);
+                    } else if (key == "units") {
+                        item.units = std::move(value);
+                    }
+                    skip_json_whitespace(json, pos);
+                    if (pos < json.size() && json[pos] == ',') {
+                        ++pos;
+                        continue;
+                    }
+                    if (pos < json.size() && json[pos] == '}') {
+                        ++pos;
+                        break;
+                    }
+                    return "missing ',' or '}' in convert_batch object";
+                }
+            }
+            items.push_back(std::move(item));
+            if (items.size() > max_batch_size) {
+                return "convert_batch is limited to " +
+                    std::to_string(max_batch_size) + " conversions";
+            }
+            skip_json_whitespace(json, pos);
+            if (pos < json.size() && json[pos] == ',') {
+                ++pos;
+                skip_json_whitespace(json, pos);
+                continue;
+            }
+            if (pos < json.size() && json[pos] == ']') {
+                ++pos;
+                break;
+            }
+            return "missing ',' or ']' in convert_batch array";
+        }
+    }
+    skip_json_whitespace(json, pos);
+    if (pos != json.size()) {
+        return "unexpected characters after the convert_batch array";
+    }
+    return std::string{};
+}
+
+// convert a batch of measurements and generate the JSON array of results,
+// each distinct unit string is only parsed once
+static std::string convert_batch(const std::vector<batch_item>& items)
+{
+    std::vector<std::string> measurements;
+    measurements.reserve(items.size());
+    for (const auto& item : items) {
+        measurements.push_back(item.measurement);
+    }
+    std::vector<units::precise_measurement> results;
+    std::vector<units::precise_unit> to_units(items.size());
+    {
+        phase_timer timer(parse_phase);
+        units::measurement_from_string(measurements, results);
+        std::unordered_map<std::string, units::precise_unit> conversion_units;
+        for (std::size_t ii = 0; ii < items.size(); ++ii) {
+            const auto& unit_string = items[ii].units;
+            if (unit_string == "*" || unit_string == "<base>") {
+                to_units[ii] = results[ii].convert_to_base().units();
+                continue;
+            }
+            auto fnd = conversion_units.find(unit_string);
+            if (fnd == conversion_units.end()) {
+                fnd = conversion_units
+                          .emplace(
+                              unit_string, units::unit_from_string(unit_string))
+                          .first;
+            }
+            to_units[ii] = fnd->second;
+        }
+    }
+    std::vector<double> values(items.size());
+    {
+        phase_timer timer(convert_phase);
+        for (std::size_t ii = 0; ii < items.size(); ++ii) {
+            values[ii] = results[ii].value_as(to_units[ii]);
+        }
+    }
+
+    phase_timer timer(format_phase);
+    std::string json{"["};
+    for (std::size_t ii = 0; ii < items.size(); ++ii) {
+        const auto& meas = results[ii];
+        const auto& u2 = to_units[ii];
+        const bool valid = isnormal(meas) && isnormal(u2);
+        if (valid) {
+            ++success_count;
+        } else {
+            ++fail_count;
+        }
+        auto value = values[ii];
+        if (ii > 0) {
+            json.push_back(',');
+        }
+        json.append("\n{\"measurement\":\"");
+        json.append(json_escape(items[ii].measurement));
+        json.append("\",\"units\":\"");
+        json.append(json_escape(
+            (items[ii].units == "*" || items[ii].units == "<base>") ?
+                units::to_string(u2) :
+                items[ii].units));
+        json.append("\",\"value\":");
+        json.append(std::isfinite(value) ? as_string(value) : "null");
+        json.append(",\"valid\":");
+        json.append(valid ? "true}" : "false}");
+    }
+    json.append("\n]");
+    return json;
+}
+
+// Returns the response to a conversion, or a not modified response if the
+// client already has it
+template<class Body, class Allocator>
+http::response<http::string_body> conversion_response(
+    const http::request<Body, http::basic_fields<Allocator>>& req,
+    const cached_response& response)
+{
+    const bool not_modified =
+        etag_matches(req[http::field::if_none_match], response.etag);
+    http::response<http::string_body> res{
+        not_modified ? http::status::not_modified : http::status::ok,
+        req.version()};
+    res.set(http::field::server, "UNITS WEB SERVER" UNITS_VERSION_STRING);
+    res.set(http::field::etag, response.etag);
+    res.keep_alive(req.keep_alive());
+    if (not_modified) {
+        return res;
+    }
+    res.set(http::field::content_type, response.content_type);
+    if (req.method() != http::verb::head) {
+        res.body() = response.body;
+        res.prepare_payload();
+    } else {
+        res.content_length(response.body.size());
+    }
+    return res;
+}
+
 // This function produces an HTTP response for the given
 // request. The type of the response object depends on the
 // contents of the request, so the interface requires the
 // caller to pass a generic lambda for receiving the response.
+// A conversion request already read from the request can be passed in so
+// the parameters are not read again.
 template<class Body, class Allocator, class Send>
 void handle_request(
     http::request<Body, http::basic_fields<Allocator>>&& req,
-    Send&& send)
+    Send&& send,
+    const conversion_request* parsed = nullptr)
 {
     static const auto index_page = loadFile("index.html");
-    static const auto response_page = loadFile("convert.html");
-    static const std::string response_json{R"({
+    static const response_template response_page{loadFile("convert.html")};
+    static const response_template response_json{R"({
 "request_measurement":"$M1$",
 "request_units":"$U1$",
 "measurement":"$M2$",
@@ -244,68 +1059,38 @@ void handle_request(
         return res;
     };
 
-    // generate a conversion response
-    auto const html_response =
-        [&req](
-            const std::string& html_page,
-            const std::vector<std::pair<std::string, std::string>>&
-                substitutions) {
-            http::response<http::string_body> res{
-                http::status::ok, req.version()};
-            res.set(
-                http::field::server, "UNITS WEB SERVER" UNITS_VERSION_STRING);
-            res.set(http::field::content_type, "text/html");
-            res.keep_alive(req.keep_alive());
-            auto resp = html_page;
-            string_substitution(resp, substitutions);
-
-            if (req.method() != http::verb::head) {
-                res.body() = resp;
-                res.prepare_payload();
-            } else {
-                res.content_length(resp.size());
-            }
-            return res;
-        };
-    // generate a conversion response
-    auto const trivial_response = [&req](const std::string& value) {
+    // generate the metrics in the Prometheus text exposition format
+    auto const metrics_response = [&req]() {
         http::response<http::string_body> res{http::status::ok, req.version()};
         res.set(http::field::server, "UNITS WEB SERVER" UNITS_VERSION_STRING);
-        res.set(http::field::content_type, "text/plain");
+        res.set(
+            http::field::content_type,
+            "text/plain; version=0.0.4; charset=utf-8");
         res.keep_alive(req.keep_alive());
+        auto metrics = generate_metrics();
         if (req.method() != http::verb::head) {
-            res.body() = value;
+            res.body() = std::move(metrics);
             res.prepare_payload();
         } else {
-            res.content_length(value.size());
+            res.content_length(metrics.size());
         }
         return res;
     };
 
     // generate a conversion response
-    auto const json_response =
-        [&req](
-            const std::string& json_string,
-            const std::vector<std::pair<std::string, std::string>>&
-                substitutions) {
-            http::response<http::string_body> res{
-                http::status::ok, req.version()};
-            res.set(
-                http::field::server, "UNITS WEB SERVER" UNITS_VERSION_STRING);
-            res.set(http::field::content_type, "application/json");
-            res.keep_alive(req.keep_alive());
-            auto resp = json_string;
-            string_substitution(resp, substitutions);
-
-            if (req.method() != http::verb::head) {
-                res.body() = resp;
-                res.prepare_payload();
-            } else {
-                res.content_length(resp.size());
-            }
-
-            return res;
-        };
+    auto const json_response = [&req](std::string json) {
+        http::response<http::string_body> res{http::status::ok, req.version()};
+        res.set(http::field::server, "UNITS WEB SERVER" UNITS_VERSION_STRING);
+        res.set(http::field::content_type, "application/json");
+        res.keep_alive(req.keep_alive());
+        if (req.method() != http::verb::head) {
+            res.body() = std::move(json);
+            res.prepare_payload();
+        } else {
+            res.content_length(json.size());
+        }
+        return res;
+    };
     ++request_count;
 
     switch (req.method()) {
@@ -314,75 +1099,210 @@ void handle_request(
         case http::verb::get:
             break;
         default:
+            ++endpoint_requests[other_endpoint];
             return send(bad_request("Unknown HTTP-method"));
     }
     beast::string_view target(req.target());
     if (target == "/" || target == "/index.html") {
+        ++endpoint_requests[index_endpoint];
         return send(main_page());
     }
 
+    if (target == "/metrics") {
+        ++endpoint_requests[metrics_endpoint];
+        return send(metrics_response());
+    }
+
     if (target.compare(0, 8, "/convert") != 0) {
+        ++endpoint_requests[other_endpoint];
         return send(not_found(target));
     }
 
-    auto reqpr = process_request_parameters(target, req.body());
-    std::string measurement;
-    std::string toUnits;
-    auto& fields = reqpr.second;
-    if (fields.find("measurement") != fields.end()) {
-        measurement = fields["measurement"];
-        if (measurement.size() > 256) {
-            return send(bad_request(
-                "measurement string size exceeds limits of 256 characters"));
+    if (target.compare(0, 14, "/convert_batch") == 0) {
+        ++endpoint_requests[convert_batch_endpoint];
+        if (req.method() != http::verb::post) {
+            return send(bad_request("convert_batch requires a POST request"));
         }
-    }
-    if (fields.find("units") != fields.end()) {
-        toUnits = fields["units"];
-        if (toUnits.size() > 256) {
-            return send(bad_request(
-                "conversion units string size greater than 256 characters"));
+        std::vector<batch_item> items;
+        auto error = read_batch_request(req.body(), items);
+        if (!error.empty()) {
+            return send(bad_request(error));
         }
+        return send(json_response(convert_batch(items)));
     }
-    bool tstring{false};
-    if (fields.find("caction") != fields.end()) {
-        if (fields["caction"] == "to_string") {
-            tstring = true;
-        } else if (fields["caction"] == "reset") {
-            return send(main_page());
-        }
+
+    const conversion_request conv = (parsed != nullptr) ?
+        *parsed :
+        read_conversion_request(target, req.body());
+    count_conversion(conv);
+    if (!conv.error.empty()) {
+        return send(bad_request(conv.error));
+    }
+    if (conv.reset) {
+        return send(main_page());
     }
-    auto meas = units::measurement_from_string(measurement);
+    units::precise_measurement meas;
     units::precise_unit u2;
+    {
+        phase_timer timer(parse_phase);
+        meas = units::measurement_from_string(conv.measurement);
+        if (conv.units == "*" || conv.units == "<base>") {
+            u2 = meas.convert_to_base().units();
+        } else {
+            u2 = units::unit_from_string(conv.units);
+        }
+    }
+    const bool valid = isnormal(meas) && isnormal(u2);
+    if (valid) {
+        ++success_count;
+    } else {
+        ++fail_count;
+    }
+    double value{0.0};
+    {
+        phase_timer timer(convert_phase);
+        value = meas.value_as(u2);
+    }
+    phase_timer timer(format_phase);
+    auto toUnits = conv.units;
     if (toUnits == "*" || toUnits == "<base>") {
-        u2 = meas.convert_to_base().units();
         toUnits = units::to_string(u2);
+    }
+    auto Vstr = as_string(value);
+
+    auto response = std::make_shared<cached_response>();
+    response->valid = valid;
+    if (conv.format == "convert" || conv.format == "convert_json") {
+        const std::string measString =
+            (conv.to_string) ? units::to_string(meas) : std::string{};
+        const std::string unitString =
+            (conv.to_string) ? units::to_string(u2) : std::string{};
+        const std::array<beast::string_view, slot_count> values{
+            {conv.measurement,
+             toUnits,
+             Vstr,
+             (conv.to_string) ? beast::string_view{measString} :
+                                beast::string_view{conv.measurement},
+             (conv.to_string) ? beast::string_view{unitString} :
+                                beast::string_view{toUnits}}};
+        if (conv.format == "convert") {
+            response->body = response_page.render(values);
+            response->content_type = "text/html";
+        } else {
+            response->body = response_json.render(values);
+            response->content_type = "application/json";
+        }
     } else {
-        u2 = units::unit_from_string(toUnits);
+        response->body = std::move(Vstr);
+        response->content_type = "text/plain";
+    }
+    response->etag = make_etag(response->body);
+    if (conversion_cache.enabled()) {
+        conversion_cache.insert(response_key(conv), response);
+    }
+    return send(conversion_response(req, *response));
+}
+
+// check if a request target needs a unit conversion
+static bool is_conversion(beast::string_view target)
+{
+    return target.compare(0, 8, "/convert") == 0;
+}
+
+// check if a request target is a batch of unit conversions
+static bool is_batch_conversion(beast::string_view target)
+{
+    return target.compare(0, 14, "/convert_batch") == 0;
+}
+
+// Returns a response for when the compute pool is full
+template<class Body, class Allocator>
+http::response<http::string_body> busy_response(
+    const http::request<Body, http::basic_fields<Allocator>>& req)
+{
+    http::response<http::string_body> res{
+        http::status::service_unavailable, req.version()};
+    res.set(http::field::server, "UNITS WEB SERVER" UNITS_VERSION_STRING);
+    res.set(http::field::content_type, "text/html");
+    res.set(http::field::retry_after, "1");
+    res.keep_alive(req.keep_alive());
+    res.body() = "The server is busy, try again later.";
+    res.prepare_payload();
+    ++busy_count;
+    return res;
+}
+
+// Respond to a conversion from the response cache without parsing any units,
+// returns false if the response has to be generated
+template<class Body, class Allocator, class Send>
+bool respond_from_cache(
+    const http::request<Body, http::basic_fields<Allocator>>& req,
+    const conversion_request& conv,
+    Send&& send)
+{
+    if (!conversion_cache.enabled() || !conv.error.empty() || conv.reset) {
+        return false;
     }
-    if (isnormal(meas) && isnormal(u2)) {
+    switch (req.method()) {
+        case http::verb::head:
+        case http::verb::post:
+        case http::verb::get:
+            break;
+        default:
+            return false;
+    }
+    auto response = conversion_cache.find(response_key(conv));
+    if (!response) {
+        return false;
+    }
+    ++request_count;
+    count_conversion(conv);
+    if (response->valid) {
         ++success_count;
     } else {
         ++fail_count;
     }
-    auto Vstr = as_string(meas.value_as(u2));
-    std::vector<std::pair<std::string, std::string>> substitutions{
-        {"$M1$", measurement},
-        {"$U1$", toUnits},
-        {"$VALUE$", Vstr},
-        {"$M2$", (tstring) ? units::to_string(meas) : measurement},
-        {"$U2$", (tstring) ? units::to_string(u2) : toUnits}};
-
-    if (reqpr.first == "convert") {
-        return send(html_response(response_page, substitutions));
-    } else if (reqpr.first == "convert_json") {
-        return send(json_response(response_json, substitutions));
-    } else {
-        return send(trivial_response(Vstr));
-    }
+    send(conversion_response(req, *response));
+    return true;
 }
 
 //------------------------------------------------------------------------------
 
+// Runs the conversions off the I/O threads.  The number of waiting jobs is
+// limited so a flood of slow conversions is turned away instead of queuing
+// without bound.
+class compute_pool {
+  public:
+    compute_pool(std::size_t threads, std::size_t max_pending) :
+        pool_(threads), max_pending_(max_pending)
+    {
+    }
+
+    // Queue a job, returns false if too many jobs are already waiting
+    template<class Job>
+    bool try_post(Job&& job)
+    {
+        if (pending_.fetch_add(1) >= max_pending_) {
+            --pending_;
+            return false;
+        }
+        net::post(pool_, [this, job = std::forward<Job>(job)]() mutable {
+            job();
+            --pending_;
+        });
+        return true;
+    }
+
+    void join() { pool_.join(); }
+
+  private:
+    net::thread_pool pool_;
+    std::atomic<std::size_t> pending_{0};
+    std::size_t max_pending_;
+};
+
+//------------------------------------------------------------------------------
+
 // Report a failure
 void fail(beast::error_code ec, char const* what)
 {
@@ -398,6 +1318,7 @@ void display_counts()
               << '\n';
     std::cout << "total requests :" << request_count.load() << '\n';
     std::cout << "bad requests :" << bad_request_count.load() << '\n';
+    std::cout << "busy responses :" << busy_count.load() << '\n';
     std::cout << "success_count :" << success_count.load() << '\n';
     std::cout << "failed_count :" << fail_count.load() << '\n';
     std::cout << "==================================================="
@@ -437,16 +1358,35 @@ class session : public std::enable_shared_from_this<session> {
         }
     };
 
+    // Sends a message from the compute pool.  The write is posted to the
+    // strand of the session so the stream is only used from one thread at a
+    // time.
+    struct strand_send {
+        std::shared_ptr<session> self_;
+
+        template<bool isRequest, class Body, class Fields>
+        void operator()(http::message<isRequest, Body, Fields>&& msg) const
+        {
+            auto sp = std::make_shared<http::message<isRequest, Body, Fields>>(
+                std::move(msg));
+            auto self = self_;
+            net::post(self->stream_.get_executor(), [self, sp]() {
+                self->lambda_(std::move(*sp));
+            });
+        }
+    };
+
     beast::tcp_stream stream_;
     beast::flat_buffer buffer_;
     http::request<http::string_body> req_;
     std::shared_ptr<void> res_;
     send_lambda lambda_;
+    compute_pool& compute_;
 
   public:
     // Take ownership of the stream
-    explicit session(tcp::socket&& socket) :
-        stream_(std::move(socket)), lambda_(*this)
+    session(tcp::socket&& socket, compute_pool& compute) :
+        stream_(std::move(socket)), lambda_(*this), compute_(compute)
     {
     }
 
@@ -484,8 +1424,33 @@ class session : public std::enable_shared_from_this<session> {
             return;
         }
 
-        // Send the response
-        handle_request(std::move(req_), lambda_);
+        ++in_flight_requests;
+        if (!is_conversion(req_.target())) {
+            // Send the response
+            return handle_request(std::move(req_), lambda_);
+        }
+        // the parameters are read once and handed on to the compute job
+        std::shared_ptr<const conversion_request> conv;
+        if (!is_batch_conversion(req_.target())) {
+            conv = std::make_shared<const conversion_request>(
+                read_conversion_request(req_.target(), req_.body()));
+            if (respond_from_cache(req_, *conv, lambda_)) {
+                return;
+            }
+        }
+        // Convert on the compute pool so slow parses don't hold up the I/O
+        auto req =
+            std::make_shared<http::request<http::string_body>>(std::move(req_));
+        ++queued_conversions;
+        auto posted = compute_.try_post(
+            [send = strand_send{shared_from_this()}, req, conv]() {
+                --queued_conversions;
+                handle_request(std::move(*req), send, conv.get());
+            });
+        if (!posted) {
+            --queued_conversions;
+            lambda_(busy_response(*req));
+        }
     }
 
     void on_write(
@@ -494,6 +1459,7 @@ class session : public std::enable_shared_from_this<session> {
         std::size_t bytes_transferred)
     {
         boost::ignore_unused(bytes_transferred);
+        --in_flight_requests;
 
         if (ec) return fail(ec, "write");
 
@@ -526,10 +1492,14 @@ class session : public std::enable_shared_from_this<session> {
 class listener : public std::enable_shared_from_this<listener> {
     net::io_context& ioc_;
     tcp::acceptor acceptor_;
+    compute_pool& compute_;
 
   public:
-    listener(net::io_context& ioc, tcp::endpoint endpoint) :
-        ioc_(ioc), acceptor_(net::make_strand(ioc))
+    listener(
+        net::io_context& ioc,
+        tcp::endpoint endpoint,
+        compute_pool& compute) :
+        ioc_(ioc), acceptor_(net::make_strand(ioc)), compute_(compute)
     {
         beast::error_code ec;
 
@@ -581,7 +1551,7 @@ class listener : public std::enable_shared_from_this<listener> {
             fail(ec, "accept");
         } else {
             // Create the session and run it
-            std::make_shared<session>(std::move(socket))->run();
+            std::make_shared<session>(std::move(socket), compute_)->run();
         }
 
         // Accept another connection
@@ -605,27 +1575,79 @@ void printer(const boost::system::error_code& e)
 int main(int argc, char* argv[])
 {
     // Check command line arguments.
-    if (argc < 3) {
-        std::cerr << "Usage: unit_web_server <address> <port>\n"
+    if (argc < 3 || argc % 2 == 0) {
+        std::cerr << "Usage: unit_web_server <address> <port> [--threads N] "
+                     "[--compute-threads N] [--max-pending N] "
+                     "[--unit-cache N] [--response-cache N]\n"
                   << "Example:\n"
-                  << "    unit_web_server 0.0.0.0 80\n";
+                  << "    unit_web_server 0.0.0.0 80 --threads 4\n";
         return EXIT_FAILURE;
     }
     auto const address = net::ip::make_address(argv[1]);
     auto const port = static_cast<std::uint16_t>(std::atoi(argv[2]));
+    // the number of threads running the io_context
+    int threads{1};
+    // the number of threads doing conversions
+    int compute_threads{
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()))};
+    // the number of conversions which can be waiting before the server
+    // responds that it is busy
+    int max_pending{1024};
+    // the capacity of the unit library string caches, 0 to disable them
+    int unit_cache{0};
+    // the number of conversion responses to cache, 0 to disable the cache
+    int response_entries{4096};
+    for (int ii = 3; ii + 1 < argc; ii += 2) {
+        const std::string option{argv[ii]};
+        const int value = std::max(1, std::atoi(argv[ii + 1]));
+        if (option == "--unit-cache") {
+            unit_cache = std::max(0, std::atoi(argv[ii + 1]));
+        } else if (option == "--response-cache") {
+            response_entries = std::max(0, std::atoi(argv[ii + 1]));
+        } else if (option == "--threads") {
+            threads = value;
+        } else if (option == "--compute-threads") {
+            compute_threads = value;
+        } else if (option == "--max-pending") {
+            max_pending = value;
+        } else {
+            std::cerr << "unknown option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    conversion_cache.set_capacity(static_cast<std::size_t>(response_entries));
+    if (unit_cache > 0) {
+        units::enableUnitStringCache(static_cast<std::size_t>(unit_cache));
+        units::enableUnitOutputCache(static_cast<std::size_t>(unit_cache));
+    }
 
     // The io_context is required for all I/O
-    net::io_context ioc{1};
+    net::io_context ioc{threads};
+
+    compute_pool compute(
+        static_cast<std::size_t>(compute_threads),
+        static_cast<std::size_t>(max_pending));
 
     // Create and launch a listening port
-    std::make_shared<listener>(ioc, tcp::endpoint{address, port})->run();
+    std::make_shared<listener>(ioc, tcp::endpoint{address, port}, compute)
+        ->run();
     // Create and launch a display timer
     tmr = std::make_shared<boost::asio::deadline_timer>(
         ioc, boost::posix_time::seconds(print_interval));
     // Posts the timer event
     tmr->async_wait(printer);
-    // Run the I/O service
+    // Run the I/O service on the requested number of threads
+    std::vector<std::thread> io_threads;
+    io_threads.reserve(threads - 1);
+    for (int ii = 1; ii < threads; ++ii) {
+        io_threads.emplace_back([&ioc] { ioc.run(); });
+    }
     ioc.run();
+    for (auto& thread : io_threads) {
+        thread.join();
+    }
+    compute.join();
 
     return EXIT_SUCCESS;
 }